@@ -0,0 +1,47 @@
+#ifndef PCBROUTER_BASE_COST_JOURNAL_H
+#define PCBROUTER_BASE_COST_JOURNAL_H
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+// Base cost added to the grid by a route, as runs of consecutive cell ids
+// sharing the same delta. Replaying it negated rips the route up without
+// re-rasterizing the paths, and subtracts exactly the deltas that were added.
+class BaseCostJournal {
+   public:
+    struct Run {
+        int cellId;  // first cell of the run
+        int length;
+        float delta;
+    };
+
+    // Build from the raw (cellId, delta) writes of a rasterization, the deltas of a cell are merged
+    void build(std::vector<std::pair<int, float>> &deltas) {
+        mRuns.clear();
+        std::stable_sort(deltas.begin(), deltas.end(),
+                         [](const std::pair<int, float> &a, const std::pair<int, float> &b) { return a.first < b.first; });
+        for (std::size_t i = 0; i < deltas.size();) {
+            int cellId = deltas[i].first;
+            float delta = 0.0;
+            for (; i < deltas.size() && deltas[i].first == cellId; ++i) {
+                delta += deltas[i].second;
+            }
+            if (!mRuns.empty() && mRuns.back().cellId + mRuns.back().length == cellId && mRuns.back().delta == delta) {
+                ++mRuns.back().length;
+            } else {
+                mRuns.push_back(Run{cellId, 1, delta});
+            }
+        }
+        mRuns.shrink_to_fit();
+    }
+
+    const std::vector<Run> &getRuns() const { return mRuns; }
+    bool empty() const { return mRuns.empty(); }
+    std::size_t getMemoryBytes() const { return mRuns.capacity() * sizeof(Run); }
+
+   private:
+    std::vector<Run> mRuns;
+};
+
+#endif
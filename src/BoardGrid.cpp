@@ -6,48 +6,36 @@ void BoardGrid::initilization(int w, int h, int l) {
     this->l = l;
     this->size = w * h * l;
 
-    assert(this->grid == nullptr);
-    this->grid = new GridCell[this->size];
-    assert(this->grid != nullptr);
-
-    this->base_cost_fill(0.0);
-    // this->via_cost_fill(0.0);
-}
-
-void BoardGrid::base_cost_fill(float value) {
-    for (int i = 0; i < this->size; ++i) {
-        this->grid[i].baseCost = value;
+    // Through-hole vias expand to every layer, bounded by the neighbor buffer
+    if (l > NeighborBuffer::kMaxNumLayers) {
+        std::cerr << __FUNCTION__ << "(): Number of layers " << l << " exceeds the maximum " << NeighborBuffer::kMaxNumLayers << " of NeighborBuffer" << std::endl;
+        assert(false);
     }
-}
 
-void BoardGrid::working_cost_fill(float value) {
-    for (int i = 0; i < this->size; ++i) {
-        this->grid[i].workingCost = value;
-    }
-}
+    assert(this->mBaseCost.empty());
+    this->mBaseCost.resize(this->size);
+    this->mCellType.resize(this->size, GridCellType::VACANT);
+    this->mNumTraces.resize(this->size, 0);
+    this->mHistoryCongestionCost.resize(this->size, 0.0);
 
-void BoardGrid::bending_cost_fill(float value) {
-    for (int i = 0; i < this->size; ++i) {
-        this->grid[i].bendingCost = value;
-    }
-}
+    this->base_cost_fill(0.0);
+    // this->via_cost_fill(0.0);
 
-void BoardGrid::cached_trace_cost_fill(float value) {
-    for (int i = 0; i < this->size; ++i) {
-        this->grid[i].cachedTraceCost = value;
-    }
+    this->setupSearchWorkspace(this->mWorkspace);
 }
 
-void BoardGrid::cached_via_cost_fill(float value) {
+void BoardGrid::base_cost_fill(float value) {
     for (int i = 0; i < this->size; ++i) {
-        this->grid[i].cachedViaCost = value;
+        this->logBaseCostChange(i);
+        this->mBaseCost[i] = value;
     }
+    this->markAllCostDirty();
 }
 
 // void BoardGrid::via_cost_fill(float value) {
 //     for (int i = 0; i < this->size; ++i) {
 //         //this->grid[i].viaCost = value;
-//         this->grid[i].baseCost = value;
+//         this->mBaseCost[i] = value;
 //     }
 // }
 
@@ -55,7 +43,7 @@ float BoardGrid::base_cost_at(const Location &l) const {
 #ifdef BOUND_CHECKS
     assert((l.m_x + l.m_y * this->w + l.m_z * this->w * this->h) < this->size);
 #endif
-    return this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].baseCost;
+    return this->mBaseCost[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h];
 }
 
 float BoardGrid::via_cost_at(const Location &l) const {
@@ -63,49 +51,25 @@ float BoardGrid::via_cost_at(const Location &l) const {
     assert((l.m_x + l.m_y * this->w + l.m_z * this->w * this->h) < this->size);
 #endif
     //return this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].viaCost;
-    return this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].baseCost;
-}
-
-float BoardGrid::working_cost_at(const Location &l) const {
-#ifdef BOUND_CHECKS
-    assert((l.m_x + l.m_y * this->w + l.m_z * this->w * this->h) < this->size);
-#endif
-    return this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].workingCost;
-}
-
-float BoardGrid::bending_cost_at(const Location &l) const {
-#ifdef BOUND_CHECKS
-    assert((l.m_x + l.m_y * this->w + l.m_z * this->w * this->h) < this->size);
-#endif
-    return this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].bendingCost;
-}
-
-float BoardGrid::cached_trace_cost_at(const Location &l) const {
-#ifdef BOUND_CHECKS
-    assert((l.m_x + l.m_y * this->w + l.m_z * this->w * this->h) < this->size);
-#endif
-    return this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].cachedTraceCost;
-}
-
-float BoardGrid::cached_via_cost_at(const Location &l) const {
-#ifdef BOUND_CHECKS
-    assert((l.m_x + l.m_y * this->w + l.m_z * this->w * this->h) < this->size);
-#endif
-    return this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].cachedViaCost;
+    return this->mBaseCost[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h];
 }
 
 void BoardGrid::base_cost_set(float value, const Location &l) {
 #ifdef BOUND_CHECKS
     assert(l.m_x + l.m_y * this->w + l.m_z * this->w * this->h < this->size);
 #endif
-    this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].baseCost = value;
+    const int id = l.m_x + l.m_y * this->w + l.m_z * this->w * this->h;
+    this->logBaseCostChange(id);
+    this->mBaseCost[id] = value;
+    this->markCostDirty(id);
 }
 
 void BoardGrid::base_cost_add(float value, const Location &l) {
 #ifdef BOUND_CHECKS
     assert(l.m_x + l.m_y * this->w + l.m_z * this->w * this->h < this->size);
 #endif
-    this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].baseCost += value;
+    const int id = l.m_x + l.m_y * this->w + l.m_z * this->w * this->h;
+    this->addBaseCostDelta(id, value);
 }
 
 void BoardGrid::base_cost_add(float value, const Location &l, const std::vector<Point_2D<int>> &shapeToGrids) {
@@ -113,62 +77,78 @@ void BoardGrid::base_cost_add(float value, const Location &l, const std::vector<
 #ifdef BOUND_CHECKS
         assert(((l.m_x + relativePt.x()) + (l.m_y + relativePt.y()) * this->w + (l.m_z) * this->w * this->h) < this->size);
 #endif
-        this->grid[(l.m_x + relativePt.x()) + (l.m_y + relativePt.y()) * this->w + (l.m_z) * this->w * this->h].baseCost += value;
+        const int id = (l.m_x + relativePt.x()) + (l.m_y + relativePt.y()) * this->w + (l.m_z) * this->w * this->h;
+        this->addBaseCostDelta(id, value);
     }
 }
 
-void BoardGrid::working_cost_set(float value, const Location &l) {
-#ifdef BOUND_CHECKS
-    assert(l.m_x + l.m_y * this->w + l.m_z * this->w * this->h < this->size);
-#endif
-    this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].workingCost = value;
-}
-
-void BoardGrid::bending_cost_set(float value, const Location &l) {
-#ifdef BOUND_CHECKS
-    assert(l.m_x + l.m_y * this->w + l.m_z * this->w * this->h < this->size);
-#endif
-    this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].bendingCost = value;
-}
-
-void BoardGrid::cached_trace_cost_set(float value, const Location &l) {
-#ifdef BOUND_CHECKS
-    assert(l.m_x + l.m_y * this->w + l.m_z * this->w * this->h < this->size);
-#endif
-    this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].cachedTraceCost = value;
-}
-
-void BoardGrid::cached_via_cost_set(float value, const Location &l) {
-#ifdef BOUND_CHECKS
-    assert(l.m_x + l.m_y * this->w + l.m_z * this->w * this->h < this->size);
-#endif
-    this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].cachedViaCost = value;
-}
-
-void BoardGrid::setCameFromId(const Location &l, const int id) {
-#ifdef BOUND_CHECKS
-    assert(l.m_x + l.m_y * this->w + l.m_z * this->w * this->h < this->size);
-#endif
-    this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].cameFromId = id;
-}
-
-int BoardGrid::getCameFromId(const Location &l) const {
-#ifdef BOUND_CHECKS
-    assert(l.m_x + l.m_y * this->w + l.m_z * this->w * this->h < this->size);
-#endif
-    return this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].cameFromId;
-}
-
-int BoardGrid::getCameFromId(const int id) const {
-#ifdef BOUND_CHECKS
-    assert(id < this->size);
-#endif
-    return this->grid[id].cameFromId;
-}
-
-void BoardGrid::clearAllCameFromId() {
-    for (int i = 0; i < this->size; ++i) {
-        this->grid[i].cameFromId = -1;
+void BoardGrid::showSearchPerformance() {
+    const auto &stats = this->mWorkspace.getStatistics();
+    std::cout << "# Grid size (w x h x l): " << this->w << " x " << this->h << " x " << this->l << " = " << this->size << " cells" << std::endl;
+    std::cout << "# Search state reset: " << (GlobalParam::gSearchEpochReset ? "epoch" : "full-grid fill") << std::endl;
+    std::cout << "# Connections searched: " << stats.numSearches << std::endl;
+    if (stats.numSearches > 0) {
+        std::cout << "# Avg. time per connection: " << stats.searchTime * 1000.0 / stats.numSearches << " ms" << std::endl;
+        std::cout << "# Avg. reset time per connection: " << stats.searchResetTime * 1000.0 / stats.numSearches << " ms" << std::endl;
+    }
+    if (stats.searchTime > 0.0) {
+        std::cout << "# Expansions per second: " << stats.numExpansions / stats.searchTime << std::endl;
+    }
+    if (GlobalParam::gRowPrefixSumCost) {
+        std::cout << "# Row prefix-sum updates: " << this->mNumRowPrefixUpdates << std::endl;
+    }
+    if (this->mNumJournalRipups + this->mNumRasterRipups > 0) {
+        std::cout << "# Rip-ups by journal replay: " << this->mNumJournalRipups << ", time: " << this->mJournalRipupTime << " s";
+        if (this->mNumJournalRipups > 0) {
+            std::cout << " (" << this->mJournalRipupTime * 1000.0 / this->mNumJournalRipups << " ms per net)";
+        }
+        std::cout << std::endl;
+        std::cout << "# Rip-ups by re-rasterization: " << this->mNumRasterRipups << ", time: " << this->mRasterRipupTime << " s";
+        if (this->mNumRasterRipups > 0) {
+            std::cout << " (" << this->mRasterRipupTime * 1000.0 / this->mNumRasterRipups << " ms per net)";
+        }
+        std::cout << std::endl;
+    }
+    if (this->mNumJournals > 0) {
+        std::cout << "# Base cost journals recorded: " << this->mNumJournals << ", avg. memory per net: " << (double)this->mJournalBytes / this->mNumJournals << " bytes" << std::endl;
+    }
+    if (GlobalParam::gPersistentViaCost) {
+        std::cout << "# Persistent via cost tiles refreshed: " << this->mWorkspace.getNumViaCostTileRefreshes() << std::endl;
+    }
+    if (GlobalParam::gPersistentTraceCost) {
+        std::cout << "# Persistent trace cost tiles refreshed: " << this->mWorkspace.getNumTraceCostTileRefreshes() << std::endl;
+    }
+    const char *frontierNames[] = {"binary heap", "indexed 4-ary heap", "radix queue"};
+    std::cout << "# Frontier: " << frontierNames[GlobalParam::gFrontierType] << std::endl;
+    std::cout << "# Expansions: " << stats.numExpansions << std::endl;
+    std::cout << "# Frontier pushes: " << stats.numFrontierPushes << std::endl;
+    std::cout << "# Stale pops: " << stats.numStalePops << std::endl;
+    std::cout << "# Re-expansions: " << stats.numReExpansions << std::endl;
+    if (stats.numWindowSearches > 0) {
+        std::cout << "# Bounded window searches: " << stats.numWindowSearches << ", retries in larger windows: " << stats.numWindowRetries << std::endl;
+    }
+    if (stats.numCorridorSearches > 0) {
+        std::cout << "# Corridor searches (global routing or coarse path bands): " << stats.numCorridorSearches << ", retries without the corridor: " << stats.numCorridorRetries << std::endl;
+    }
+    if (stats.numHierarchicalSearches > 0) {
+        std::cout << "# Coarse-to-fine searches: " << stats.numHierarchicalSearches << " on pyramid level " << GlobalParam::gHierarchicalSearchLevel
+                  << ", retries without the band: " << stats.numHierarchicalRetries << ", coarse expansions: " << stats.numCoarseExpansions
+                  << ", pyramid block updates: " << this->mNumCostPyramidUpdates << std::endl;
+    }
+    if (stats.numIncrementalNets > 0) {
+        std::cout << "# Incremental searches: " << stats.numResumedSearches << " resumed connections of " << stats.numIncrementalNets << " multi-pin nets"
+                  << ", settled cells reused: " << stats.numReusedSettledCells
+                  << " (" << (double)stats.numReusedSettledCells / stats.numIncrementalNets << " per net)" << std::endl;
+    }
+    if (this->mNumParallelBatches > 0) {
+        std::cout << "# Parallel batches: " << this->mNumParallelBatches << ", nets: " << this->mNumParallelNets
+                  << ", avg. nets per batch: " << (double)this->mNumParallelNets / this->mNumParallelBatches << std::endl;
+        std::cout << "# Parallel workers: " << this->mMaxNumWorkers << ", nets routed serially after their batch: " << this->mNumParallelFallbacks << std::endl;
+        std::cout << "# Parallel routing wall time: " << this->mParallelRoutingTime << " s, searching: " << this->mParallelSearchTime << " s" << std::endl;
+        if (this->mParallelSearchTime > 0.0) {
+            // Search time summed over the workers against the wall time
+            std::cout << "# Parallel search speedup: " << this->mParallelWorkerSearchTime / this->mParallelSearchTime << std::endl;
+        }
     }
 }
 
@@ -187,7 +167,10 @@ void BoardGrid::via_cost_set(const float value, const Location &l) {
     assert(l.m_x + l.m_y * this->w + l.m_z * this->w * this->h < this->size);
 #endif
     //this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].viaCost = value;
-    this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].baseCost = value;
+    const int id = l.m_x + l.m_y * this->w + l.m_z * this->w * this->h;
+    this->logBaseCostChange(id);
+    this->mBaseCost[id] = value;
+    this->markCostDirty(id);
 }
 
 void BoardGrid::via_cost_add(const float value, const Location &l) {
@@ -195,42 +178,8 @@ void BoardGrid::via_cost_add(const float value, const Location &l) {
     assert(l.m_x + l.m_y * this->w + l.m_z * this->w * this->h < this->size);
 #endif
     //this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].viaCost += value;
-    this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].baseCost += value;
-}
-
-void BoardGrid::setTargetedPin(const Location &l) {
-#ifdef BOUND_CHECKS
-    assert(l.m_x + l.m_y * this->w + l.m_z * this->w * this->h < this->size);
-#endif
-    //this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].targetedPin = true;
-    this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].cellType = GridCellType::TARGET_PIN;
-}
-
-void BoardGrid::clearTargetedPin(const Location &l) {
-#ifdef BOUND_CHECKS
-    assert(l.m_x + l.m_y * this->w + l.m_z * this->w * this->h < this->size);
-#endif
-    //this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].targetedPin = false;
-    this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].cellType = GridCellType::VACANT;
-}
-
-bool BoardGrid::isTargetedPin(const Location &l) {
-#ifdef BOUND_CHECKS
-    assert(l.m_x + l.m_y * this->w + l.m_z * this->w * this->h < this->size);
-#endif
-    //return this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].targetedPin;
-    return this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].cellType == GridCellType::TARGET_PIN;
-}
-
-void BoardGrid::setTargetedPins(const std::vector<Location> &pins) {
-    for (const auto &pin : pins) {
-        this->setTargetedPin(pin);
-    }
-}
-void BoardGrid::clearTargetedPins(const std::vector<Location> &pins) {
-    for (const auto &pin : pins) {
-        this->clearTargetedPin(pin);
-    }
+    const int id = l.m_x + l.m_y * this->w + l.m_z * this->w * this->h;
+    this->addBaseCostDelta(id, value);
 }
 
 void BoardGrid::setViaForbidden(const Location &l) {
@@ -238,7 +187,10 @@ void BoardGrid::setViaForbidden(const Location &l) {
     assert(l.m_x + l.m_y * this->w + l.m_z * this->w * this->h < this->size);
 #endif
     // this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].viaForbidden = true;
-    this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].cellType = GridCellType::VIA_FORBIDDEN;
+    const int id = l.m_x + l.m_y * this->w + l.m_z * this->w * this->h;
+    this->logCellTypeChange(id);
+    this->mCellType[id] = GridCellType::VIA_FORBIDDEN;
+    this->markCostDirty(id);
 }
 
 void BoardGrid::clearViaForbidden(const Location &l) {
@@ -246,7 +198,10 @@ void BoardGrid::clearViaForbidden(const Location &l) {
     assert(l.m_x + l.m_y * this->w + l.m_z * this->w * this->h < this->size);
 #endif
     // this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].viaForbidden = false;
-    this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].cellType = GridCellType::VACANT;
+    const int id = l.m_x + l.m_y * this->w + l.m_z * this->w * this->h;
+    this->logCellTypeChange(id);
+    this->mCellType[id] = GridCellType::VACANT;
+    this->markCostDirty(id);
 }
 
 bool BoardGrid::isViaForbidden(const Location &l) const {
@@ -254,7 +209,7 @@ bool BoardGrid::isViaForbidden(const Location &l) const {
     assert(l.m_x + l.m_y * this->w + l.m_z * this->w * this->h < this->size);
 #endif
     // return this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].viaForbidden;
-    return this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].cellType == GridCellType::VIA_FORBIDDEN;
+    return this->mCellType[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h] == GridCellType::VIA_FORBIDDEN;
 }
 
 void BoardGrid::setViaForbiddenArea(const std::vector<Location> &locations) {
@@ -397,21 +352,22 @@ void BoardGrid::clearViaForbiddenArea(const std::vector<Location> &locations) {
 //     }
 // }
 
-void BoardGrid::aStarWithGridCameFrom(const std::vector<Location> &route, Location &finalEnd, float &finalCost) {
-    std::cout << __FUNCTION__ << "() nets: route.features.size() = " << route.size() << std::endl;
+void BoardGrid::aStarWithGridCameFrom(SearchWorkspace &ws, const std::vector<Location> &route, Location &finalEnd, float &finalCost) const {
+    ws.log() << __FUNCTION__ << "() nets: route.features.size() = " << route.size() << std::endl;
 
     // For path to multiple points
     // Searches from the multiple points to every other point
-    this->working_cost_fill(std::numeric_limits<float>::infinity());
-    this->bending_cost_fill(0);
+    ws.working_cost_fill(std::numeric_limits<float>::infinity());
+    ws.bending_cost_fill(0);
 
     float bestCostWhenReachTarget = std::numeric_limits<float>::max();
-    LocationQueue<Location, float> frontier;  // search frontier
-    this->initializeFrontiers(route, frontier);
+    BinaryHeapFrontier frontier;  // search frontier
+    NeighborBuffer neighbors;
+    this->initializeFrontiers(ws, route, frontier);
 
-    std::cout << " frontier.size(): " << frontier.size() << ", current targeted pin:  " << std::endl;
-    for (const auto &pt : currentTargetedPinWithLayers) {
-        std::cout << "  " << pt << std::endl;
+    ws.log() << " frontier.size(): " << frontier.size() << ", current targeted pin:  " << std::endl;
+    for (const auto &pt : ws.getCurrentTargetedPinWithLayers()) {
+        ws.log() << "  " << pt << std::endl;
     }
 
     // int numPopLocation = 0;
@@ -427,42 +383,42 @@ void BoardGrid::aStarWithGridCameFrom(const std::vector<Location> &route, Locati
         // std::cout << "==>Current pop " << numPopLocation << " at Loc: " << current << ", expanded from Loc: " << prev << ", with Key in queue: " << frontier.frontKey() << std::endl;
 
         // A* termination
-        if (isTargetedPin(current)) {
+        if (ws.isTargetedPin(current)) {
             bestCostWhenReachTarget = frontier.frontKey();
             finalEnd = current;
             finalCost = bestCostWhenReachTarget;
-            std::cout << "=> Find the target: " << current << " with cost at " << bestCostWhenReachTarget << std::endl;
+            ws.log() << "=> Find the target: " << current << " with cost at " << bestCostWhenReachTarget << std::endl;
             return;
         }
 
         frontier.pop();
 
-        std::vector<std::pair<float, Location>> neighbors;
-        this->getNeighbors(current, neighbors);
-        float current_cost = this->working_cost_at(current);
+        neighbors.clear();
+        this->getNeighbors(ws, current, neighbors);
+        float current_cost = ws.working_cost_at(current);
 
         for (std::pair<float, Location> &next : neighbors) {
             float new_cost = current_cost + next.first;  // Can be optimized!!!!
 
             //float estCost = getAStarEstimatedCost(next.second);
             // Test bending cost
-            float estCost = getAStarEstimatedCost(current, next.second);
-            int bendCost = getBendingCostOfNext(current, next.second);
+            float estCost = getAStarEstimatedCost(ws, current, next.second);
+            int bendCost = getBendingCostOfNext(ws, current, next.second);
 
-            if (new_cost + bendCost < this->working_cost_at(next.second) + this->bending_cost_at(next.second)) {
+            if (new_cost + bendCost < ws.working_cost_at(next.second) + ws.bending_cost_at(next.second)) {
                 //if () {
-                this->working_cost_set(new_cost, next.second);
-                this->bending_cost_set(bendCost, next.second);
-                this->setCameFromId(next.second, this->locationToId(current));
+                ws.working_cost_set(new_cost, next.second);
+                ws.bending_cost_set(bendCost, next.second);
+                ws.setCameFromId(next.second, this->locationToId(current));
 
-                frontier.push(next.second, new_cost + estCost + bendCost);
+                frontier.push(next.second, this->locationToId(next.second), new_cost + estCost + bendCost);
 
                 // float keyValue = new_cost + estCost + bendCost;
                 // std::cout << "Better Cost at Location " << next.second << ", with Cost: " << new_cost << ", est Cost: " << estCost << ", bend Cost: " << bendCost << ", key value: " << keyValue << std::endl;
 
                 // Show if the target is reached
-                if (isTargetedPin(next.second)) {
-                    std::cout << "Find target with estCost = " << estCost << ", walkedCost = " << new_cost << ", bend Cost: " << bendCost
+                if (ws.isTargetedPin(next.second)) {
+                    ws.log() << "Find target with estCost = " << estCost << ", walkedCost = " << new_cost << ", bend Cost: " << bendCost
                               << ", currentLoc: " << current << ", nextLoc: " << next.second << std::endl;
                 }
             }
@@ -470,81 +426,515 @@ void BoardGrid::aStarWithGridCameFrom(const std::vector<Location> &route, Locati
     }
     //For Dijkstra to output
     finalCost = bestCostWhenReachTarget;
-    std::cout << "=> Find the target with cost at " << bestCostWhenReachTarget << std::endl;
+    ws.log() << "=> Find the target with cost at " << bestCostWhenReachTarget << std::endl;
+}
+
+bool BoardGrid::aStarSearching(SearchWorkspace &ws, MultipinRoute &route, Location &finalEnd, float &finalCost) const {
+    ws.log() << __FUNCTION__ << "() nets: route.mGridPaths.size() = " << route.mGridPaths.size() << std::endl;
+
+    auto searchStart = std::chrono::steady_clock::now();
+    ++ws.getStatistics().numSearches;
+    bool found = false;
+
+    if (ws.hasSearchCorridor()) {
+        ++ws.getStatistics().numCorridorSearches;
+    }
+    while (true) {
+        if (GlobalParam::gBoundedSearchWindow) {
+            // Search around the source tree and the targets first, grow the window until a path is found
+            ++ws.getStatistics().numWindowSearches;
+            int minX = 0, minY = 0, maxX = 0, maxY = 0;
+            this->getSearchBoundingBox(ws, route, minX, minY, maxX, maxY);
+            double margin = GlobalParam::gSearchWindowMargin;
+            while (true) {
+                int windowMargin = static_cast<int>(margin);
+                ws.setSearchWindow(minX - windowMargin, minY - windowMargin, maxX + windowMargin, maxY + windowMargin);
+                found = this->aStarSearchingInWindow(ws, route, finalEnd, finalCost);
+                if (found || ws.isSearchWindowAtLimit()) {
+                    break;
+                }
+                ws.log() << "No path in the search window with margin " << windowMargin << ", retry in a larger window" << std::endl;
+                ++ws.getStatistics().numWindowRetries;
+                margin = std::max(margin * GlobalParam::gSearchWindowGrowth, margin + 1.0);
+            }
+            ws.resetSearchWindow();
+        } else {
+            found = this->aStarSearchingInWindow(ws, route, finalEnd, finalCost);
+        }
+        if (found || !ws.hasSearchCorridor()) {
+            break;
+        }
+        // The corridor is too tight, e.g. the free tracks of its GCells are taken by the detailed paths of other nets,
+        // or the coarse path's band misses a gap its pooled costs don't show
+        ws.log() << "No path in the search corridor, retry without it" << std::endl;
+        ++ws.getStatistics().numCorridorRetries;
+        ws.clearSearchCorridor();
+    }
+
+    ws.getStatistics().searchTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - searchStart).count();
+    return found;
 }
 
-void BoardGrid::aStarSearching(MultipinRoute &route, Location &finalEnd, float &finalCost) {
-    std::cout << __FUNCTION__ << "() nets: route.mGridPaths.size() = " << route.mGridPaths.size() << std::endl;
+bool BoardGrid::aStarSearchingInWindow(SearchWorkspace &ws, MultipinRoute &route, Location &finalEnd, float &finalCost) const {
+    ws.resetSearchStateForNewSearch();
 
-    this->working_cost_fill(std::numeric_limits<float>::infinity());
-    this->bending_cost_fill(0);
+    switch (GlobalParam::gFrontierType) {
+        case FrontierType::INDEXED_QUATERNARY_HEAP:
+            ws.getIndexedHeapFrontier().setup(this->size);
+            return this->aStarSearchingWithFrontier(ws, route, ws.getIndexedHeapFrontier(), finalEnd, finalCost);
+        case FrontierType::RADIX_QUEUE:
+            return this->aStarSearchingWithFrontier(ws, route, ws.getRadixQueueFrontier(), finalEnd, finalCost);
+        default:
+            return this->aStarSearchingWithFrontier(ws, route, ws.getBinaryHeapFrontier(), finalEnd, finalCost);
+    }
+}
 
-    float bestCostWhenReachTarget = std::numeric_limits<float>::max();
-    LocationQueue<Location, float> frontier;  // search frontier
+bool BoardGrid::growSearchTree(SearchWorkspace &ws, MultipinRoute &route) const {
+    ws.log() << __FUNCTION__ << "() route.gridPins.size: " << route.mGridPins.size() << std::endl;
+
+    auto searchStart = std::chrono::steady_clock::now();
+    ++ws.getStatistics().numSearches;
+    ws.resetSearchStateForNewSearch();
+
+    bool connected = false;
+    switch (GlobalParam::gFrontierType) {
+        case FrontierType::INDEXED_QUATERNARY_HEAP:
+            ws.getIndexedHeapFrontier().setup(this->size);
+            connected = this->growSearchTreeWithFrontier(ws, route, ws.getIndexedHeapFrontier());
+            break;
+        case FrontierType::RADIX_QUEUE:
+            connected = this->growSearchTreeWithFrontier(ws, route, ws.getRadixQueueFrontier());
+            break;
+        default:
+            connected = this->growSearchTreeWithFrontier(ws, route, ws.getBinaryHeapFrontier());
+            break;
+    }
+
+    ws.getStatistics().searchTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - searchStart).count();
+    return connected;
+}
+
+template <typename Frontier>
+bool BoardGrid::growSearchTreeWithFrontier(SearchWorkspace &ws, MultipinRoute &route, Frontier &frontier) const {
+    frontier.clear();
+    NeighborBuffer neighbors;  // reused by every expansion
+
+    // All the other pins are targets, the closest one is connected first
+    std::vector<bool> connectedPins(route.mGridPins.size(), false);
+    connectedPins.front() = true;
+    int numRemainingPins = static_cast<int>(route.mGridPins.size()) - 1;
+    std::vector<Location> targets;
+    auto setRemainingTargets = [&ws, &route, &connectedPins, &targets]() {
+        targets.clear();
+        for (std::size_t i = 0; i < route.mGridPins.size(); ++i) {
+            if (!connectedPins.at(i)) {
+                targets.insert(targets.end(), route.mGridPins.at(i).pinWithLayers.begin(), route.mGridPins.at(i).pinWithLayers.end());
+            }
+        }
+        ws.setCurrentTargets(targets);
+    };
+    setRemainingTargets();
+
+    // Grow from the first pin
+    for (const auto &pt : route.mGridPins.front().pinWithLayers) {
+        this->initializeLocationToFrontier(ws, pt, frontier);
+    }
+
+    while (numRemainingPins > 0 && !frontier.empty()) {
+        Location current = frontier.front();
+        float currentKey = frontier.frontKey();
+        frontier.pop();
+
+        if (!ws.isTargetedPin(current)) {
+            // Closed-set check, skip the outdated duplicated entries
+            if (ws.closeFrontierEntry(current, currentKey)) {
+                this->expandFrontierEntry(ws, route, current, neighbors, frontier);
+            }
+            continue;
+        }
+        // Same for the targets: an outdated entry, e.g. pushed before the tree grew, doesn't hold the cost of the path to backtrack
+        if (ws.frontier_key_at(current) != currentKey) {
+            ++ws.getStatistics().numStalePops;
+            continue;
+        }
+
+        // A pin is reached, connect it to the tree
+        ws.log() << "=> Find the target: " << current << " with cost at " << currentKey << std::endl;
+        route.currentRouteCost += currentKey;
+        if (GlobalParam::gBacktrackToSegments) {
+            this->backtrackingToGridPathSegments(ws, current, route);
+        } else {
+            this->backtrackingToGridPath(ws, current, route);
+        }
+
+        std::size_t reachedPinId = 0;
+        for (std::size_t i = 1; i < route.mGridPins.size() && reachedPinId == 0; ++i) {
+            const auto &pinWithLayers = route.mGridPins.at(i).pinWithLayers;
+            if (!connectedPins.at(i) && std::find(pinWithLayers.begin(), pinWithLayers.end(), current) != pinWithLayers.end()) {
+                reachedPinId = i;
+            }
+        }
+        ws.clearCurrentTargets();
+        connectedPins.at(reachedPinId) = true;
+        --numRemainingPins;
+        if (numRemainingPins == 0) {
+            break;
+        }
+        setRemainingTargets();
+
+        // The new path and pin are sources at zero cost, the search continues from the current tree
+        frontier.resetMonotoneBound();
+        this->initializeGridPathToFrontier(ws, route.mGridPaths.back(), frontier);
+        for (const auto &pt : route.mGridPins.at(reachedPinId).pinWithLayers) {
+            this->initializeLocationToFrontier(ws, pt, frontier);
+        }
+    }
+
+    if (numRemainingPins > 0) {
+        ws.log() << __FUNCTION__ << "(): " << numRemainingPins << " pins can't be reached" << std::endl;
+    }
+    ws.clearCurrentTargets();
+    return numRemainingPins == 0;
+}
+
+void BoardGrid::getSearchBoundingBox(const SearchWorkspace &ws, const MultipinRoute &route, int &minX, int &minY, int &maxX, int &maxY) const {
+    minX = this->w - 1;
+    minY = this->h - 1;
+    maxX = 0;
+    maxY = 0;
+    auto addLocation = [&minX, &minY, &maxX, &maxY](const Location &loc) {
+        minX = std::min(minX, loc.m_x);
+        minY = std::min(minY, loc.m_y);
+        maxX = std::max(maxX, loc.m_x);
+        maxY = std::max(maxY, loc.m_y);
+    };
+
+    for (const auto &pt : ws.getCurrentTargetedPinWithLayers()) {
+        addLocation(pt);
+    }
+    for (const auto &gp : route.getGridPaths()) {
+        for (const auto &location : gp.getCells()) {
+            addLocation(location);
+        }
+    }
+    // Same starting pins as initializeFrontiers()
+    int numConnectedPins = route.getNumConnectedGridPins();
+    for (int i = 0; i < numConnectedPins && i < static_cast<int>(route.getGridPins().size()); ++i) {
+        for (const auto &location : route.getGridPins().at(i).getPinWithLayers()) {
+            addLocation(location);
+        }
+    }
+}
+
+bool BoardGrid::aStarSearchingHierarchically(SearchWorkspace &ws, MultipinRoute &route, Location &finalEnd, float &finalCost) const {
+    // A global routing corridor or a batch window already bounds the search,
+    // the coarse search would read the pooled costs outside the window
+    if (ws.hasSearchCorridor() || ws.hasSearchWindowLimit()) {
+        return this->aStarSearching(ws, route, finalEnd, finalCost);
+    }
+
+    // Connections that fit in a band anyway are searched directly
+    const int level = std::max(static_cast<int>(GlobalParam::gHierarchicalSearchLevel), 1);
+    const int margin = GlobalParam::gHierarchicalBandMargin;
+    const int cellSize = 1 << level;
+    int minX = 0, minY = 0, maxX = 0, maxY = 0;
+    this->getSearchBoundingBox(ws, route, minX, minY, maxX, maxY);
+    if (maxX / cellSize - minX / cellSize <= 2 * margin && maxY / cellSize - minY / cellSize <= 2 * margin) {
+        return this->aStarSearching(ws, route, finalEnd, finalCost);
+    }
+
+    this->updateCostPyramid();
+    std::vector<int> band;
+    if (!this->getCoarsePathBand(ws, route, level, margin, band)) {
+        return this->aStarSearching(ws, route, finalEnd, finalCost);
+    }
+
+    // Refine in the band, aStarSearching() retries without it if the band has no path
+    ++ws.getStatistics().numHierarchicalSearches;
+    const long long numCorridorRetries = ws.getStatistics().numCorridorRetries;
+    ws.setSearchCorridor(band, cellSize);
+    bool found = this->aStarSearching(ws, route, finalEnd, finalCost);
+    ws.getStatistics().numHierarchicalRetries += ws.getStatistics().numCorridorRetries - numCorridorRetries;
+    ws.clearSearchCorridor();
+    return found;
+}
+
+bool BoardGrid::getCoarsePathBand(SearchWorkspace &ws, const MultipinRoute &route, const int level, const int margin, std::vector<int> &band) const {
+    band.clear();
+    const int cellSize = 1 << level;
+    const int levelW = this->mCostPyramidW[level - 1];
+    const int levelH = this->mCostPyramidH[level - 1];
+    const int numCells = levelW * levelH * this->l;
+    auto getCoarseId = [cellSize, levelW, levelH](const Location &loc) {
+        return loc.m_x / cellSize + (loc.m_y / cellSize) * levelW + loc.m_z * levelW * levelH;
+    };
+
+    std::vector<char> isTarget(numCells, 0);
+    int targetMinX = levelW, targetMinY = levelH, targetMaxX = -1, targetMaxY = -1;
+    for (const auto &pt : ws.getCurrentTargetedPinWithLayers()) {
+        isTarget[getCoarseId(pt)] = 1;
+        targetMinX = std::min(targetMinX, pt.m_x / cellSize);
+        targetMinY = std::min(targetMinY, pt.m_y / cellSize);
+        targetMaxX = std::max(targetMaxX, pt.m_x / cellSize);
+        targetMaxY = std::max(targetMaxY, pt.m_y / cellSize);
+    }
+    if (targetMaxX < 0) {
+        return false;
+    }
+    // Distance to the targets' bounding box, every planar step costs at least cellSize
+    auto estimatedCost = [=](const int x, const int y) {
+        const int dx = std::max(std::max(targetMinX - x, x - targetMaxX), 0);
+        const int dy = std::max(std::max(targetMinY - y, y - targetMaxY), 0);
+        return (float)((dx + dy) * cellSize);
+    };
+
+    std::vector<float> cost(numCells, std::numeric_limits<float>::infinity());
+    std::vector<int> cameFrom(numCells, -1);
+    std::priority_queue<std::pair<float, int>, std::vector<std::pair<float, int>>, std::greater<std::pair<float, int>>> frontier;
+    auto addSource = [&](const Location &loc) {
+        const int id = getCoarseId(loc);
+        if (cost[id] > 0.0) {
+            cost[id] = 0.0;
+            frontier.emplace(estimatedCost(loc.m_x / cellSize, loc.m_y / cellSize), id);
+        }
+    };
+    // Same sources as initializeFrontiers()
+    for (const auto &gp : route.getGridPaths()) {
+        for (const auto &location : gp.getCells()) {
+            addSource(location);
+        }
+    }
+    int numConnectedPins = route.getNumConnectedGridPins();
+    for (int i = 0; i < numConnectedPins && i < static_cast<int>(route.getGridPins().size()); ++i) {
+        for (const auto &location : route.getGridPins().at(i).getPinWithLayers()) {
+            addSource(location);
+        }
+    }
+
+    int reachedId = -1;
+    while (!frontier.empty()) {
+        const float key = frontier.top().first;
+        const int id = frontier.top().second;
+        frontier.pop();
+        const int x = id % levelW;
+        const int y = (id / levelW) % levelH;
+        const int z = id / (levelW * levelH);
+        if (key > cost[id] + estimatedCost(x, y)) {
+            continue;
+        }
+        if (isTarget[id]) {
+            reachedId = id;
+            break;
+        }
+        ++ws.getStatistics().numCoarseExpansions;
+
+        auto relax = [&](const int nextId, const int nextX, const int nextY, const float stepCost) {
+            const float newCost = cost[id] + stepCost;
+            if (newCost < cost[nextId]) {
+                cost[nextId] = newCost;
+                cameFrom[nextId] = id;
+                frontier.emplace(newCost + estimatedCost(nextX, nextY), nextId);
+            }
+        };
+        // A trace crosses cellSize of the cell's cellSize x cellSize cells, at their average cost
+        auto relaxPlanar = [&](const int nextX, const int nextY) {
+            const int nextId = nextX + nextY * levelW + z * levelW * levelH;
+            relax(nextId, nextX, nextY, cellSize + this->pooled_cost_at(level, nextX, nextY, z) / cellSize);
+        };
+        if (x > 0) relaxPlanar(x - 1, y);
+        if (x + 1 < levelW) relaxPlanar(x + 1, y);
+        if (y > 0) relaxPlanar(x, y - 1);
+        if (y + 1 < levelH) relaxPlanar(x, y + 1);
+        if (GlobalParam::gAllowViaForRouting) {
+            if (z + 1 < this->l) relax(id + levelW * levelH, x, y, GlobalParam::gLayerChangeCost);
+            if (z > 0) relax(id - levelW * levelH, x, y, GlobalParam::gLayerChangeCost);
+        }
+    }
+    if (reachedId < 0) {
+        return false;
+    }
+
+    // Planar cells of the coarse path, dilated by margin cells
+    std::vector<char> isInBand(levelW * levelH, 0);
+    for (int id = reachedId; id != -1; id = cameFrom[id]) {
+        const int x = id % levelW;
+        const int y = (id / levelW) % levelH;
+        for (int by = std::max(y - margin, 0); by <= std::min(y + margin, levelH - 1); ++by) {
+            for (int bx = std::max(x - margin, 0); bx <= std::min(x + margin, levelW - 1); ++bx) {
+                if (!isInBand[bx + by * levelW]) {
+                    isInBand[bx + by * levelW] = 1;
+                    band.push_back(bx + by * levelW);
+                }
+            }
+        }
+    }
+    return true;
+}
+
+template <typename Frontier>
+bool BoardGrid::aStarSearchingWithFrontier(SearchWorkspace &ws, MultipinRoute &route, Frontier &frontier, Location &finalEnd, float &finalCost) const {
+    frontier.clear();  // search frontier
 
     // For path to multiple points. Searches from the multiple points to every other point
-    this->initializeFrontiers(route, frontier);
+    this->initializeFrontiers(ws, route, frontier);
 
-    std::cout << " frontier.size(): " << frontier.size() << ", current targeted pin:  " << std::endl;
-    for (const auto &pt : currentTargetedPinWithLayers) {
-        std::cout << "  " << pt << std::endl;
+    ws.log() << " frontier.size(): " << frontier.size() << ", current targeted pin:  " << std::endl;
+    for (const auto &pt : ws.getCurrentTargetedPinWithLayers()) {
+        ws.log() << "  " << pt << std::endl;
     }
 
+    return this->searchFrontierForTargets(ws, route, frontier, finalEnd, finalCost);
+}
+
+template <typename Frontier>
+bool BoardGrid::searchFrontierForTargets(SearchWorkspace &ws, MultipinRoute &route, Frontier &frontier, Location &finalEnd, float &finalCost) const {
+    float bestCostWhenReachTarget = std::numeric_limits<float>::max();
+    NeighborBuffer neighbors;  // reused by every expansion
+
     while (!frontier.empty()) {
         Location current = frontier.front();
+        float currentKey = frontier.frontKey();
         // cout << "Search Location: " << frontier.front() << ", with key: " << frontier.frontKey() << std::endl;
 
         // A* termination
-        if (isTargetedPin(current)) {
-            bestCostWhenReachTarget = frontier.frontKey();
+        if (ws.isTargetedPin(current)) {
+            bestCostWhenReachTarget = currentKey;
             finalEnd = current;
             finalCost = bestCostWhenReachTarget;
-            std::cout << "=> Find the target: " << current << " with cost at " << bestCostWhenReachTarget << std::endl;
-            return;
+            ws.log() << "=> Find the target: " << current << " with cost at " << bestCostWhenReachTarget << std::endl;
+            return true;
         }
 
         frontier.pop();
 
-        std::vector<std::pair<float, Location>> neighbors;
-        this->getNeighbors(current, neighbors);
-        float current_cost = this->working_cost_at(current);
+        // Closed-set check, skip the outdated duplicated entries
+        if (!ws.closeFrontierEntry(current, currentKey)) {
+            continue;
+        }
 
-        for (std::pair<float, Location> &next : neighbors) {
-            float new_cost = current_cost + next.first;  // Can be optimized!!!!
+        this->expandFrontierEntry(ws, route, current, neighbors, frontier);
+    }
+    return false;
+}
 
-            //float estCost = getAStarEstimatedCost(next.second);
-            // Test bending cost
-            float estCost = getAStarEstimatedCost(current, next.second);
-            int bendCost = getBendingCostOfNext(current, next.second);
-            pr::prIntCost layerPrefCost = getLayerPrefCost(route, next.second);
-            new_cost += layerPrefCost;
+bool BoardGrid::aStarSearchingIncrementally(SearchWorkspace &ws, MultipinRoute &route, Location &finalEnd, float &finalCost) const {
+    ws.log() << __FUNCTION__ << "() nets: route.mGridPaths.size() = " << route.mGridPaths.size() << std::endl;
 
-            // std::cout << "Neighbor with estCost = " << estCost << ", currentCost = " << current_cost
-            //           << ", Walked+ObstableCost = " << next.first << ", bend Cost: " << bendCost
-            //           << ", currentLoc: " << current << ", nextLoc: " << next.second << std::endl;
+    auto searchStart = std::chrono::steady_clock::now();
+    ++ws.getStatistics().numSearches;
+    ++ws.getStatistics().numResumedSearches;
+    bool found = false;
 
-            if (new_cost + bendCost < this->working_cost_at(next.second) + this->bending_cost_at(next.second)) {
-                this->working_cost_set(new_cost, next.second);
-                this->bending_cost_set(bendCost, next.second);
-                this->setCameFromId(next.second, this->locationToId(current));
+    // No reset, the search state of the previous connection is kept
+    switch (GlobalParam::gFrontierType) {
+        case FrontierType::INDEXED_QUATERNARY_HEAP:
+            found = this->resumeSearchWithFrontier(ws, route, ws.getIndexedHeapFrontier(), finalEnd, finalCost);
+            break;
+        case FrontierType::RADIX_QUEUE:
+            found = this->resumeSearchWithFrontier(ws, route, ws.getRadixQueueFrontier(), finalEnd, finalCost);
+            break;
+        default:
+            found = this->resumeSearchWithFrontier(ws, route, ws.getBinaryHeapFrontier(), finalEnd, finalCost);
+            break;
+    }
 
-                frontier.push(next.second, new_cost + estCost + bendCost);
+    ws.getStatistics().searchTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - searchStart).count();
+    return found;
+}
 
-                // Show if the target is reached
-                if (isTargetedPin(next.second)) {
-                    std::cout << "Find target with estCost = " << estCost << ", walkedCost = " << new_cost << ", bend Cost: " << bendCost
-                              << ", currentLoc: " << current << ", nextLoc: " << next.second << std::endl;
-                }
+template <typename Frontier>
+bool BoardGrid::resumeSearchWithFrontier(SearchWorkspace &ws, MultipinRoute &route, Frontier &frontier, Location &finalEnd, float &finalCost) const {
+    // Walked costs only depend on the sources, which have grown, so the costs found by the previous
+    // connection are still upper bounds. Only the estimated costs change with the targets.
+    auto estimatedCostAt = [this, &ws](const Location &l) {
+        Location prev;
+        this->idToLocation(ws.getCameFromId(l), prev);
+        return prev == l ? this->getAStarEstimatedCost(ws, l) : this->getAStarEstimatedCost(ws, prev, l);
+    };
+
+    // Re-key the open cells towards the new targets, the outdated entries are dropped
+    std::vector<Location> openLocations;
+    openLocations.reserve(frontier.size());
+    while (!frontier.empty()) {
+        Location current = frontier.front();
+        float currentKey = frontier.frontKey();
+        frontier.pop();
+        if (ws.frontier_key_at(current) == currentKey) {
+            openLocations.push_back(current);
+        }
+    }
+    frontier.clear();
+    for (const auto &loc : openLocations) {
+        ws.pushToFrontier(loc, ws.working_cost_at(loc) + ws.bending_cost_at(loc) + estimatedCostAt(loc), frontier);
+    }
+
+    // The path and the pin connected last (again if the path went to a Steiner point) are new sources at zero cost, the decreased costs are
+    // propagated by re-expanding the settled cells they improve
+    this->initializeGridPathToFrontier(ws, route.mGridPaths.back(), frontier);
+    for (const auto &location : route.mGridPins.at(route.getNumConnectedGridPins() - 1).getPinWithLayers()) {
+        this->initializeLocationToFrontier(ws, location, frontier);
+    }
+
+    // Targets settled as ordinary cells before are put back, to be popped at their cost
+    for (const auto &pt : ws.getCurrentTargetedPinWithLayers()) {
+        if (ws.working_cost_at(pt) < std::numeric_limits<float>::infinity() && ws.frontier_key_at(pt) == -std::numeric_limits<float>::infinity()) {
+            ws.pushToFrontier(pt, ws.working_cost_at(pt) + ws.bending_cost_at(pt) + estimatedCostAt(pt), frontier);
+        }
+    }
+
+    ws.log() << " frontier.size(): " << frontier.size() << " (resumed), current targeted pin:  " << std::endl;
+    for (const auto &pt : ws.getCurrentTargetedPinWithLayers()) {
+        ws.log() << "  " << pt << std::endl;
+    }
+
+    return this->searchFrontierForTargets(ws, route, frontier, finalEnd, finalCost);
+}
+
+template <typename Frontier>
+void BoardGrid::expandFrontierEntry(SearchWorkspace &ws, const MultipinRoute &route, const Location &current, NeighborBuffer &neighbors, Frontier &frontier) const {
+    neighbors.clear();
+    this->getNeighbors(ws, current, neighbors);
+    float current_cost = ws.working_cost_at(current);
+
+    for (std::pair<float, Location> &next : neighbors) {
+        float new_cost = current_cost + next.first;  // Can be optimized!!!!
+
+        //float estCost = getAStarEstimatedCost(next.second);
+        // Test bending cost
+        float estCost = getAStarEstimatedCost(ws, current, next.second);
+        int bendCost = getBendingCostOfNext(ws, current, next.second);
+        pr::prIntCost layerPrefCost = getLayerPrefCost(route, next.second);
+        new_cost += layerPrefCost;
+        if (GlobalParam::gNegotiatedCongestion) {
+            new_cost += this->congestion_cost_at(next.second);
+        }
+
+        // std::cout << "Neighbor with estCost = " << estCost << ", currentCost = " << current_cost
+        //           << ", Walked+ObstableCost = " << next.first << ", bend Cost: " << bendCost
+        //           << ", currentLoc: " << current << ", nextLoc: " << next.second << std::endl;
+
+        if (new_cost + bendCost < ws.working_cost_at(next.second) + ws.bending_cost_at(next.second)) {
+            ws.working_cost_set(new_cost, next.second);
+            ws.bending_cost_set(bendCost, next.second);
+            ws.setCameFromId(next.second, this->locationToId(current));
+
+            ws.pushToFrontier(next.second, new_cost + estCost + bendCost, frontier);
+
+            // Show if the target is reached
+            if (ws.isTargetedPin(next.second)) {
+                ws.log() << "Find target with estCost = " << estCost << ", walkedCost = " << new_cost << ", bend Cost: " << bendCost
+                          << ", currentLoc: " << current << ", nextLoc: " << next.second << std::endl;
             }
         }
     }
 }
 
-void BoardGrid::initializeFrontiers(const MultipinRoute &route, LocationQueue<Location, float> &frontier) {
+template <typename Frontier>
+void BoardGrid::initializeFrontiers(SearchWorkspace &ws, const MultipinRoute &route, Frontier &frontier) const {
     if (route.getGridPaths().empty()) {
         // First pair of routing
         for (const auto &pt : route.mGridPins.front().pinWithLayers) {
-            initializeLocationToFrontier(pt, frontier);
+            initializeLocationToFrontier(ws, pt, frontier);
         }
         //     std::cout << " A* Start from: " << std::endl;
         //     for (const auto &pt : route.mGridPins.front().pinWithLayers) {
@@ -555,70 +945,79 @@ void BoardGrid::initializeFrontiers(const MultipinRoute &route, LocationQueue<Lo
         //     }
 
         //Debugging
-        std::cout << __FUNCTION__ << "(): A* Start from: " << std::endl;
+        ws.log() << __FUNCTION__ << "(): A* Start from: " << std::endl;
         for (const auto &pt : route.mGridPins.front().pinWithLayers) {
-            std::cout << "  " << pt << std::endl;
+            ws.log() << "  " << pt << std::endl;
         }
 
         return;
     }
 
     for (const auto &gp : route.getGridPaths()) {
-        const auto &locations = gp.getLocations();
-        if (locations.size() == 1) {
-            initializeLocationToFrontier(locations.front(), frontier);
-            continue;
+        this->initializeGridPathToFrontier(ws, gp, frontier);
+    }
+
+    // Add Pin locations to avoid additional via nearby through hole pins
+    int numConnectedPins = route.getNumConnectedGridPins();
+    for (int i = 0; i < numConnectedPins && i < static_cast<int>(route.getGridPins().size()); ++i) {
+        for (const auto &location : route.getGridPins().at(i).getPinWithLayers()) {
+            initializeLocationToFrontier(ws, location, frontier);
         }
+    }
+}
 
-        auto pointIte = ++locations.begin();
-        auto prevPointIte = locations.begin();
+template <typename Frontier>
+void BoardGrid::initializeGridPathToFrontier(SearchWorkspace &ws, const GridPath &gp, Frontier &frontier) const {
+    const auto locations = gp.getCells();
+    if (locations.empty()) {
+        return;
+    }
+    if (std::next(locations.begin()) == locations.end()) {
+        initializeLocationToFrontier(ws, *locations.begin(), frontier);
+        return;
+    }
 
-        for (; pointIte != locations.end();) {
-            // TODO: Through hole pins? how to put layers of through hole pins into frontier
-            if (pointIte->m_x == prevPointIte->m_x && pointIte->m_y == prevPointIte->m_y && pointIte->m_z != prevPointIte->m_z) {
-                // A via
-                if (GlobalParam::gUseMircoVia) {
-                    // Micro vias / Blind/buried vias
-                    for (int z = std::min(pointIte->m_z, prevPointIte->m_z); z <= std::max(pointIte->m_z, prevPointIte->m_z); ++z) {
-                        Location viaLocationOnALayer{pointIte->m_x, pointIte->m_y, z};
-                        initializeLocationToFrontier(viaLocationOnALayer, frontier);
-                    }
-                } else {
-                    // Put all the layers (through hole via) into the frontiers
-                    for (int z = 0; z < this->l; ++z) {
-                        Location viaLocationOnALayer{pointIte->m_x, pointIte->m_y, z};
-                        initializeLocationToFrontier(viaLocationOnALayer, frontier);
-                    }
+    auto pointIte = std::next(locations.begin());
+    auto prevPointIte = locations.begin();
+
+    for (; pointIte != locations.end();) {
+        // TODO: Through hole pins? how to put layers of through hole pins into frontier
+        if (pointIte->m_x == prevPointIte->m_x && pointIte->m_y == prevPointIte->m_y && pointIte->m_z != prevPointIte->m_z) {
+            // A via
+            if (GlobalParam::gUseMircoVia) {
+                // Micro vias / Blind/buried vias
+                for (int z = std::min(pointIte->m_z, prevPointIte->m_z); z <= std::max(pointIte->m_z, prevPointIte->m_z); ++z) {
+                    Location viaLocationOnALayer{pointIte->m_x, pointIte->m_y, z};
+                    initializeLocationToFrontier(ws, viaLocationOnALayer, frontier);
                 }
             } else {
-                // Normal points
-                initializeLocationToFrontier(*pointIte, frontier);
-
-                if (prevPointIte == locations.begin()) {
-                    initializeLocationToFrontier(*prevPointIte, frontier);
+                // Put all the layers (through hole via) into the frontiers
+                for (int z = 0; z < this->l; ++z) {
+                    Location viaLocationOnALayer{pointIte->m_x, pointIte->m_y, z};
+                    initializeLocationToFrontier(ws, viaLocationOnALayer, frontier);
                 }
             }
+        } else {
+            // Normal points
+            initializeLocationToFrontier(ws, *pointIte, frontier);
 
-            ++pointIte;
-            ++prevPointIte;
+            if (prevPointIte == locations.begin()) {
+                initializeLocationToFrontier(ws, *prevPointIte, frontier);
+            }
         }
-    }
 
-    // Add Pin locations to avoid additional via nearby through hole pins
-    int numConnectedPins = route.getGridPaths().size() + 1;
-    for (int i = 0; i < numConnectedPins && i < route.getGridPins().size(); ++i) {
-        for (const auto &location : route.getGridPins().at(i).getPinWithLayers()) {
-            initializeLocationToFrontier(location, frontier);
-        }
+        ++pointIte;
+        ++prevPointIte;
     }
 }
 
-void BoardGrid::initializeFrontiers(const std::vector<Location> &route, LocationQueue<Location, float> &frontier) {
+template <typename Frontier>
+void BoardGrid::initializeFrontiers(SearchWorkspace &ws, const std::vector<Location> &route, Frontier &frontier) const {
     if (route.empty()) {
         return;
     }
     if (route.size() == 1) {
-        initializeLocationToFrontier(route.front(), frontier);
+        initializeLocationToFrontier(ws, route.front(), frontier);
     }
 
     for (int i = 1; i < route.size(); ++i) {
@@ -632,61 +1031,63 @@ void BoardGrid::initializeFrontiers(const std::vector<Location> &route, Location
                 // Micro vias / Blind/buried vias
                 for (int z = std::min(location.m_z, prevLocation.m_z); z <= std::max(location.m_z, prevLocation.m_z); ++z) {
                     Location viaLocationOnALayer{location.m_x, location.m_y, z};
-                    initializeLocationToFrontier(viaLocationOnALayer, frontier);
+                    initializeLocationToFrontier(ws, viaLocationOnALayer, frontier);
                 }
             } else {
                 // Put all the layers (through hole via) into the frontiers
                 for (int z = 0; z < this->l; ++z) {
                     Location viaLocationOnALayer{location.m_x, location.m_y, z};
-                    initializeLocationToFrontier(viaLocationOnALayer, frontier);
+                    initializeLocationToFrontier(ws, viaLocationOnALayer, frontier);
                 }
             }
         } else {
             // Normal points
-            initializeLocationToFrontier(location, frontier);
+            initializeLocationToFrontier(ws, location, frontier);
 
             if (i == 1) {
-                initializeLocationToFrontier(prevLocation, frontier);
+                initializeLocationToFrontier(ws, prevLocation, frontier);
             }
         }
     }
 }
 
-void BoardGrid::initializeLocationToFrontier(const Location &start, LocationQueue<Location, float> &frontier) {
+template <typename Frontier>
+void BoardGrid::initializeLocationToFrontier(SearchWorkspace &ws, const Location &start, Frontier &frontier) const {
     // Walked cost (= 0) + estimated future cost
-    float cost = getAStarEstimatedCost(start);
+    float cost = getAStarEstimatedCost(ws, start);
 
-    this->working_cost_set(0.0, start);
-    frontier.push(start, cost);
+    ws.working_cost_set(0.0, start);
+    ws.bending_cost_set(0, start);
+    ws.pushToFrontier(start, cost, frontier);
     // std::cerr << "\tPQ: cost: " << cost << ", at" << start << std::endl;
 
     // Set a ending for the backtracking
-    this->setCameFromId(start, this->locationToId(start));
+    ws.setCameFromId(start, this->locationToId(start));
 
     // std::cout << __FUNCTION__ << "(): point: " << start << ", cost: " << cost << std::endl;
 }
 
-float BoardGrid::getAStarEstimatedCost(const Location &next) {
+float BoardGrid::getAStarEstimatedCost(const SearchWorkspace &ws, const Location &next) const {
     //2D Version
     // return this->get2dEstimatedCost(next);
-    return this->get2dMultiTargetEstimatedCost(next);
+    return this->get2dMultiTargetEstimatedCost(ws, next);
 
     //3D Version // 3D cost estimation
     // return this->get3dEstimatedCost(next);
 }
 
-float BoardGrid::getAStarEstimatedCost(const Location &current, const Location &next) {
+float BoardGrid::getAStarEstimatedCost(const SearchWorkspace &ws, const Location &current, const Location &next) const {
     //2D Version
     // return this->get2dEstimatedCostWithBendingCost(current, next);
-    return this->get2dMultiTargetEstimatedCostWithBendingCost(current, next);
+    return this->get2dMultiTargetEstimatedCostWithBendingCost(ws, current, next);
 
     //3D Version // Test bending cost + multi-layers (3D estimation cost)
     // return this->get3dEstimatedCostWithBendingCost(current, next);
 }
 
-float BoardGrid::get2dMultiTargetEstimatedCost(const Location &l) {
+float BoardGrid::get2dMultiTargetEstimatedCost(const SearchWorkspace &ws, const Location &l) const {
     float cost = std::numeric_limits<float>::infinity();
-    for (const auto &target : this->currentTargetedPinWithLayers) {
+    for (const auto &target : ws.getCurrentTargets2D()) {
         int absDiffX = abs(l.m_x - target.m_x);
         int absDiffY = abs(l.m_y - target.m_y);
         int minDiff = min(absDiffX, absDiffY);
@@ -697,9 +1098,9 @@ float BoardGrid::get2dMultiTargetEstimatedCost(const Location &l) {
     return cost;
 }
 
-float BoardGrid::get2dMultiTargetEstimatedCostWithBendingCost(const Location &current, const Location &next) {
+float BoardGrid::get2dMultiTargetEstimatedCostWithBendingCost(const SearchWorkspace &ws, const Location &current, const Location &next) const {
     int currentId = this->locationToId(current);
-    int prevId = this->getCameFromId(current);
+    int prevId = ws.getCameFromId(current);
     float bendingCost = 0;
     if (prevId != currentId) {
         Location prev;
@@ -716,35 +1117,37 @@ float BoardGrid::get2dMultiTargetEstimatedCostWithBendingCost(const Location &cu
         bendingCost += 0.5;
     }
 
-    float cost = std::numeric_limits<float>::infinity();
-    for (const auto &target : this->currentTargetedPinWithLayers) {
+    // The distance estimation is the same for all the targets, only whether a target
+    // is reachable without a bend (orthogonally or diagonally aligned) matters
+    const auto &targets = ws.getCurrentTargets2D();
+    if (targets.empty()) {
+        return std::numeric_limits<float>::infinity();
+    }
+    float estimatedCost = this->get2dMultiTargetEstimatedCost(ws, next);
+    for (const auto &target : targets) {
         if (next.m_x == target.m_x ||
             next.m_y == target.m_y ||
             abs(next.m_x - target.m_x) == abs(next.m_y - target.m_y)) {
             // bendingCost += 0.5;
-
-            cost = std::min(cost, float(this->get2dMultiTargetEstimatedCost(next) - bendingCost - 0.5));
-        } else {
-            cost = std::min(cost, this->get2dMultiTargetEstimatedCost(next) - bendingCost);
+            return float(estimatedCost - bendingCost - 0.5);
         }
     }
-
-    return cost;
+    return estimatedCost - bendingCost;
 }
 
-float BoardGrid::get2dEstimatedCost(const Location &l) {
+float BoardGrid::get2dEstimatedCost(const SearchWorkspace &ws, const Location &l) const {
     // return max(abs(l.m_x - this->current_targeted_pin.m_x), abs(l.m_y - this->current_targeted_pin.m_y));
 
-    int absDiffX = abs(l.m_x - this->current_targeted_pin.m_x);
-    int absDiffY = abs(l.m_y - this->current_targeted_pin.m_y);
+    int absDiffX = abs(l.m_x - ws.getCurrentTargetedPin().m_x);
+    int absDiffY = abs(l.m_y - ws.getCurrentTargetedPin().m_y);
     int minDiff = min(absDiffX, absDiffY);
     int maxDiff = max(absDiffX, absDiffY);
     return (float)minDiff * GlobalParam::gDiagonalCost + maxDiff - minDiff;
 }
 
-float BoardGrid::get2dEstimatedCostWithBendingCost(const Location &current, const Location &next) {
+float BoardGrid::get2dEstimatedCostWithBendingCost(const SearchWorkspace &ws, const Location &current, const Location &next) const {
     int currentId = this->locationToId(current);
-    int prevId = this->getCameFromId(current);
+    int prevId = ws.getCameFromId(current);
     float bendingCost = 0;
     if (prevId != currentId) {
         Location prev;
@@ -760,9 +1163,9 @@ float BoardGrid::get2dEstimatedCostWithBendingCost(const Location &current, cons
         // Count the starting point as zero bending
         bendingCost += 0.5;
     }
-    if (next.m_x == this->current_targeted_pin.m_x ||
-        next.m_y == this->current_targeted_pin.m_y ||
-        abs(next.m_x - this->current_targeted_pin.m_x) == abs(next.m_y - this->current_targeted_pin.m_y)) {
+    if (next.m_x == ws.getCurrentTargetedPin().m_x ||
+        next.m_y == ws.getCurrentTargetedPin().m_y ||
+        abs(next.m_x - ws.getCurrentTargetedPin().m_x) == abs(next.m_y - ws.getCurrentTargetedPin().m_y)) {
         bendingCost += 0.5;
     }
 
@@ -774,13 +1177,13 @@ float BoardGrid::get2dEstimatedCostWithBendingCost(const Location &current, cons
     // int maxDiff = max(absDiffX, absDiffY);
     // return (float)minDiff * GlobalParam::gDiagonalCost + maxDiff - minDiff - bendingCost;
 
-    return this->get2dEstimatedCost(next) - bendingCost;
+    return this->get2dEstimatedCost(ws, next) - bendingCost;
 }
 
-int BoardGrid::getBendingCostOfNext(const Location &current, const Location &next) const {
-    int currentBendingCost = this->bending_cost_at(current);
+int BoardGrid::getBendingCostOfNext(const SearchWorkspace &ws, const Location &current, const Location &next) const {
+    int currentBendingCost = ws.bending_cost_at(current);
     int currentId = this->locationToId(current);
-    int prevId = this->getCameFromId(current);
+    int prevId = ws.getCameFromId(current);
     int nextBendingCost = currentBendingCost;
 
     if (prevId != currentId) {
@@ -812,24 +1215,24 @@ pr::prIntCost BoardGrid::getLayerPrefCost(const MultipinRoute &route, const Loca
     }
 }
 
-float BoardGrid::get3dEstimatedCost(const Location &l) {
-    int absDiffX = abs(l.m_x - this->currentTargetedPinWithLayers.front().m_x);
-    int absDiffY = abs(l.m_y - this->currentTargetedPinWithLayers.front().m_y);
+float BoardGrid::get3dEstimatedCost(const SearchWorkspace &ws, const Location &l) const {
+    int absDiffX = abs(l.m_x - ws.getCurrentTargetedPinWithLayers().front().m_x);
+    int absDiffY = abs(l.m_y - ws.getCurrentTargetedPinWithLayers().front().m_y);
     int minDiff = min(absDiffX, absDiffY);
     int maxDiff = max(absDiffX, absDiffY);
     float estCost = (float)minDiff * GlobalParam::gDiagonalCost + maxDiff - minDiff;
 
     // If is SMD pin, add the layer changing cost
-    if (currentTargetedPinWithLayers.size() == 1) {
-        estCost += GlobalParam::gLayerChangeCost * abs(this->currentTargetedPinWithLayers.front().m_z - l.m_z);
+    if (ws.getCurrentTargetedPinWithLayers().size() == 1) {
+        estCost += GlobalParam::gLayerChangeCost * abs(ws.getCurrentTargetedPinWithLayers().front().m_z - l.m_z);
     }
     return estCost;
 }
 
-float BoardGrid::get3dEstimatedCostWithBendingCost(const Location &current, const Location &next) {
+float BoardGrid::get3dEstimatedCostWithBendingCost(const SearchWorkspace &ws, const Location &current, const Location &next) const {
     // Bending cost
     int currentId = this->locationToId(current);
-    int prevId = this->getCameFromId(current);
+    int prevId = ws.getCameFromId(current);
     float bendingCost = 0;
     if (prevId != currentId) {
         Location prev;
@@ -843,37 +1246,36 @@ float BoardGrid::get3dEstimatedCostWithBendingCost(const Location &current, cons
         }
     }
 
-    int absDiffX = abs(next.m_x - this->currentTargetedPinWithLayers.front().m_x);
-    int absDiffY = abs(next.m_y - this->currentTargetedPinWithLayers.front().m_y);
+    int absDiffX = abs(next.m_x - ws.getCurrentTargetedPinWithLayers().front().m_x);
+    int absDiffY = abs(next.m_y - ws.getCurrentTargetedPinWithLayers().front().m_y);
     int minDiff = min(absDiffX, absDiffY);
     int maxDiff = max(absDiffX, absDiffY);
     float estCost = (float)minDiff * GlobalParam::gDiagonalCost + maxDiff - minDiff - bendingCost;
 
     // If is SMD pin, add the layer changing cost
-    if (currentTargetedPinWithLayers.size() == 1) {
-        estCost += GlobalParam::gLayerChangeCost * abs(this->currentTargetedPinWithLayers.front().m_z - next.m_z);
+    if (ws.getCurrentTargetedPinWithLayers().size() == 1) {
+        estCost += GlobalParam::gLayerChangeCost * abs(ws.getCurrentTargetedPinWithLayers().front().m_z - next.m_z);
     }
     return estCost;
 }
 
-void BoardGrid::getNeighbors(const Location &l, std::vector<std::pair<float, Location>> &ns) {
-    auto &curGridNetclass = mGridNetclasses.at(currentGridNetclassId);
-    const auto &traceRelativeSearchGrids = curGridNetclass.getTraceSearchingSpaceToGrids();
+void BoardGrid::getNeighbors(SearchWorkspace &ws, const Location &l, NeighborBuffer &ns) const {
+    const auto &curGridNetclass = mGridNetclasses.at(ws.getCurrentGridNetclassId());
     const auto &viaRelativeSearchGrids = curGridNetclass.getViaSearchingSpaceToGrids();
 
     // For incremental cost update of trace
     // auto currentGridPenalty = this->cached_trace_cost_at(l);
 
     // left
-    if (l.m_x - 1 > -1) {
+    if (l.m_x - 1 >= ws.getWindowMinX() && ws.isInSearchCorridor(l.m_x - 1, l.m_y)) {
         Location left{l.m_x - 1, l.m_y, l.m_z};
         float leftCost = 1.0;
 
-        if (this->cached_trace_cost_at(left) == -1) {
+        if (ws.cached_trace_cost_at(left) == -1) {
             // Radius based searching
             //leftCost += sized_trace_cost_at(left, traceSearchRadius);
             // Vector based searching
-            leftCost += sized_trace_cost_at(left, traceRelativeSearchGrids);
+            leftCost += sized_trace_cost_at(left, curGridNetclass);
 
             // Incremental searching
             // leftCost += currentGridPenalty;
@@ -881,9 +1283,9 @@ void BoardGrid::getNeighbors(const Location &l, std::vector<std::pair<float, Loc
             // leftCost -= sized_trace_cost_at(l, curGridNetclass.getTraceIncrementalSearchGrids().getLeftDedGrids());
 
             // Put in the cache
-            this->cached_trace_cost_set(leftCost - 1.0, left);
+            ws.cached_trace_cost_set(leftCost - 1.0, left);
         } else {
-            leftCost += this->cached_trace_cost_at(left);
+            leftCost += ws.cached_trace_cost_at(left);
         }
         // float golden = sized_trace_cost_at(left, traceRelativeSearchGrids);
         // if(golden != cached_trace_cost_at(left) ){
@@ -899,13 +1301,13 @@ void BoardGrid::getNeighbors(const Location &l, std::vector<std::pair<float, Loc
     }
 
     // right
-    if (l.m_x + 1 < this->w) {
+    if (l.m_x + 1 <= ws.getWindowMaxX() && ws.isInSearchCorridor(l.m_x + 1, l.m_y)) {
         Location right{l.m_x + 1, l.m_y, l.m_z};
         float rightCost = 1.0;
 
-        if (this->cached_trace_cost_at(right) == -1) {
+        if (ws.cached_trace_cost_at(right) == -1) {
             //rightCost += sized_trace_cost_at(right, traceSearchRadius);
-            rightCost += sized_trace_cost_at(right, traceRelativeSearchGrids);
+            rightCost += sized_trace_cost_at(right, curGridNetclass);
 
             // Incremental searching
             // rightCost += currentGridPenalty;
@@ -913,21 +1315,21 @@ void BoardGrid::getNeighbors(const Location &l, std::vector<std::pair<float, Loc
             // rightCost -= sized_trace_cost_at(l, curGridNetclass.getTraceIncrementalSearchGrids().getRightDedGrids());
 
             // Put in cache
-            this->cached_trace_cost_set(rightCost - 1.0, right);
+            ws.cached_trace_cost_set(rightCost - 1.0, right);
         } else {
-            rightCost += this->cached_trace_cost_at(right);
+            rightCost += ws.cached_trace_cost_at(right);
         }
         ns.push_back(std::pair<float, Location>(rightCost, right));
     }
 
     // forward
-    if (l.m_y + 1 < this->h) {
+    if (l.m_y + 1 <= ws.getWindowMaxY() && ws.isInSearchCorridor(l.m_x, l.m_y + 1)) {
         Location forward{l.m_x, l.m_y + 1, l.m_z};
         float forwardCost = 1.0;
 
-        if (this->cached_trace_cost_at(forward) == -1) {
+        if (ws.cached_trace_cost_at(forward) == -1) {
             //forwardCost += sized_trace_cost_at(forward, traceSearchRadius);
-            forwardCost += sized_trace_cost_at(forward, traceRelativeSearchGrids);
+            forwardCost += sized_trace_cost_at(forward, curGridNetclass);
 
             // Incremental searching
             // forwardCost += currentGridPenalty;
@@ -935,21 +1337,21 @@ void BoardGrid::getNeighbors(const Location &l, std::vector<std::pair<float, Loc
             // forwardCost -= sized_trace_cost_at(l, curGridNetclass.getTraceIncrementalSearchGrids().getForwardDedGrids());
 
             // Put in cache
-            this->cached_trace_cost_set(forwardCost - 1.0, forward);
+            ws.cached_trace_cost_set(forwardCost - 1.0, forward);
         } else {
-            forwardCost += this->cached_trace_cost_at(forward);
+            forwardCost += ws.cached_trace_cost_at(forward);
         }
         ns.push_back(std::pair<float, Location>(forwardCost, forward));
     }
 
     // back
-    if (l.m_y - 1 > -1) {
+    if (l.m_y - 1 >= ws.getWindowMinY() && ws.isInSearchCorridor(l.m_x, l.m_y - 1)) {
         Location backward{l.m_x, l.m_y - 1, l.m_z};
         float backwardCost = 1.0;
 
-        if (this->cached_trace_cost_at(backward) == -1) {
+        if (ws.cached_trace_cost_at(backward) == -1) {
             //backwardCost += sized_trace_cost_at(backward, traceSearchRadius);
-            backwardCost += sized_trace_cost_at(backward, traceRelativeSearchGrids);
+            backwardCost += sized_trace_cost_at(backward, curGridNetclass);
 
             // Incremental searching
             // backwardCost += currentGridPenalty;
@@ -957,9 +1359,9 @@ void BoardGrid::getNeighbors(const Location &l, std::vector<std::pair<float, Loc
             // backwardCost -= sized_trace_cost_at(l, curGridNetclass.getTraceIncrementalSearchGrids().getBackwardDedGrids());
 
             // Put in cache
-            this->cached_trace_cost_set(backwardCost - 1.0, backward);
+            ws.cached_trace_cost_set(backwardCost - 1.0, backward);
         } else {
-            backwardCost += this->cached_trace_cost_at(backward);
+            backwardCost += ws.cached_trace_cost_at(backward);
         }
         ns.push_back(std::pair<float, Location>(backwardCost, backward));
     }
@@ -971,7 +1373,18 @@ void BoardGrid::getNeighbors(const Location &l, std::vector<std::pair<float, Loc
                 Location up{l.m_x, l.m_y, l.m_z + 1};
                 float upCost = 0.0;
 
-                sizedViaCostBetweenStartEndLayer(l, l.m_z, l.m_z + 1, viaRelativeSearchGrids, upCost);
+                if (ws.hasViaCostCaches()) {
+                    upCost = ws.cached_via_cost_at(l);
+                    if (upCost < -0.5) {
+                        ++ws.getStatistics().viaCachedMissed;
+                        sizedViaCostBetweenStartEndLayer(l, l.m_z, l.m_z + 1, curGridNetclass, upCost);
+                        ws.cached_via_cost_set(upCost, l);
+                    } else {
+                        ++ws.getStatistics().viaCachedHit;
+                    }
+                } else {
+                    sizedViaCostBetweenStartEndLayer(l, l.m_z, l.m_z + 1, curGridNetclass, upCost);
+                }
                 upCost += GlobalParam::gLayerChangeCost;
                 ns.push_back(std::pair<float, Location>(upCost, up));
 
@@ -983,7 +1396,18 @@ void BoardGrid::getNeighbors(const Location &l, std::vector<std::pair<float, Loc
                 Location down{l.m_x, l.m_y, l.m_z - 1};
                 float downCost = 0.0;
 
-                sizedViaCostBetweenStartEndLayer(l, l.m_z - 1, l.m_z, viaRelativeSearchGrids, downCost);
+                if (ws.hasViaCostCaches()) {
+                    downCost = ws.cached_via_cost_at(down);
+                    if (downCost < -0.5) {
+                        ++ws.getStatistics().viaCachedMissed;
+                        sizedViaCostBetweenStartEndLayer(l, l.m_z - 1, l.m_z, curGridNetclass, downCost);
+                        ws.cached_via_cost_set(downCost, down);
+                    } else {
+                        ++ws.getStatistics().viaCachedHit;
+                    }
+                } else {
+                    sizedViaCostBetweenStartEndLayer(l, l.m_z - 1, l.m_z, curGridNetclass, downCost);
+                }
                 downCost += GlobalParam::gLayerChangeCost;
                 ns.push_back(std::pair<float, Location>(downCost, down));
 
@@ -1007,26 +1431,32 @@ void BoardGrid::getNeighbors(const Location &l, std::vector<std::pair<float, Loc
             // }
 
             // Trying to cached the via cost
-            if (this->cached_via_cost_at(viaCachedLocation) < -1.5) {
+            if (ws.cached_via_cost_at(viaCachedLocation) < -1.5) {
                 // ViaForbidden location, do nothing
             } else {
-                if (this->cached_via_cost_at(viaCachedLocation) < -0.5) {
-                    ++this->viaCachedMissed;
+                if (ws.cached_via_cost_at(viaCachedLocation) < -0.5) {
+                    ++ws.getStatistics().viaCachedMissed;
 
                     // For incremental Via cost update
                     int currentId = this->locationToId(l);
-                    int prevId = this->getCameFromId(currentId);
+                    int prevId = ws.getCameFromId(currentId);
                     Location prevLocation;
                     this->idToLocation(prevId, prevLocation);
                     prevLocation.m_z = 0;  // To access the cache
-                    auto prevLocViaCost = this->cached_via_cost_at(prevLocation);
+                    auto prevLocViaCost = ws.cached_via_cost_at(prevLocation);
 
                     // No cached via cost value - correct implementation
                     // if (sizedViaExpandableAndCost(l, viaRelativeSearchGrids, viaCost)) {
-                    // No cached via cost value => try incremental cost updating
-                    if (sizedViaExpandableAndIncrementalCost(l, viaRelativeSearchGrids, prevLocation, prevLocViaCost, curGridNetclass.getViaIncrementalSearchGrids(), viaCost)) {
+                    // No cached via cost value => try incremental cost updating, or query the row prefix sums directly
+                    bool viaExpandable = true;
+                    if (GlobalParam::gRowPrefixSumCost) {
+                        sizedViaCostBetweenStartEndLayer(l, 0, this->l - 1, curGridNetclass, viaCost);
+                    } else {
+                        viaExpandable = sizedViaExpandableAndIncrementalCost(l, viaRelativeSearchGrids, prevLocation, prevLocViaCost, curGridNetclass.getViaIncrementalSearchGrids(), viaCost);
+                    }
+                    if (viaExpandable) {
                         // Put in the cache
-                        this->cached_via_cost_set(viaCost, viaCachedLocation);
+                        ws.cached_via_cost_set(viaCost, viaCachedLocation);
 
                         viaCost += GlobalParam::gLayerChangeCost;
 
@@ -1037,14 +1467,14 @@ void BoardGrid::getNeighbors(const Location &l, std::vector<std::pair<float, Loc
                         }
                     } else {
                         // Put in the cache the via forbidden flag
-                        this->cached_via_cost_set(-2.0, viaCachedLocation);
+                        ws.cached_via_cost_set(-2.0, viaCachedLocation);
                     }
 
                 } else {
-                    ++this->viaCachedHit;
+                    ++ws.getStatistics().viaCachedHit;
 
                     // Got a cached via cost value
-                    viaCost = this->cached_via_cost_at(viaCachedLocation) + GlobalParam::gLayerChangeCost;
+                    viaCost = ws.cached_via_cost_at(viaCachedLocation) + GlobalParam::gLayerChangeCost;
 
                     // Put all the layers (through hole via) into the neighbors
                     for (int z = 0; z < this->l; ++z) {
@@ -1139,9 +1569,9 @@ void BoardGrid::getNeighbors(const Location &l, std::vector<std::pair<float, Loc
         Location lf{l.m_x - 1, l.m_y + 1, l.m_z};
         float lfCost = GlobalParam::gDiagonalCost;
 
-        if (this->cached_trace_cost_at(lf) == -1) {
+        if (ws.cached_trace_cost_at(lf) == -1) {
             //lfCost += sized_trace_cost_at(lf, traceSearchRadius);
-            lfCost += sized_trace_cost_at(lf, traceRelativeSearchGrids);
+            lfCost += sized_trace_cost_at(lf, curGridNetclass);
 
             // Incremental searching
             // lfCost += currentGridPenalty;
@@ -1149,9 +1579,9 @@ void BoardGrid::getNeighbors(const Location &l, std::vector<std::pair<float, Loc
             // lfCost -= sized_trace_cost_at(l, curGridNetclass.getTraceIncrementalSearchGrids().getLFDedGrids());
 
             // Put in cache
-            this->cached_trace_cost_set(lfCost - GlobalParam::gDiagonalCost, lf);
+            ws.cached_trace_cost_set(lfCost - GlobalParam::gDiagonalCost, lf);
         } else {
-            lfCost += this->cached_trace_cost_at(lf);
+            lfCost += ws.cached_trace_cost_at(lf);
         }
 
         ns.push_back(std::pair<float, Location>(lfCost, lf));
@@ -1162,9 +1592,9 @@ void BoardGrid::getNeighbors(const Location &l, std::vector<std::pair<float, Loc
         Location lb{l.m_x - 1, l.m_y - 1, l.m_z};
         float lbCost = GlobalParam::gDiagonalCost;
 
-        if (this->cached_trace_cost_at(lb) == -1) {
+        if (ws.cached_trace_cost_at(lb) == -1) {
             //lbCost += sized_trace_cost_at(lb, traceSearchRadius);
-            lbCost += sized_trace_cost_at(lb, traceRelativeSearchGrids);
+            lbCost += sized_trace_cost_at(lb, curGridNetclass);
 
             // Incremental searching
             // lbCost += currentGridPenalty;
@@ -1172,9 +1602,9 @@ void BoardGrid::getNeighbors(const Location &l, std::vector<std::pair<float, Loc
             // lbCost -= sized_trace_cost_at(l, curGridNetclass.getTraceIncrementalSearchGrids().getLBDedGrids());
 
             // Put in cache
-            this->cached_trace_cost_set(lbCost - GlobalParam::gDiagonalCost, lb);
+            ws.cached_trace_cost_set(lbCost - GlobalParam::gDiagonalCost, lb);
         } else {
-            lbCost += this->cached_trace_cost_at(lb);
+            lbCost += ws.cached_trace_cost_at(lb);
         }
 
         ns.push_back(std::pair<float, Location>(lbCost, lb));
@@ -1185,9 +1615,9 @@ void BoardGrid::getNeighbors(const Location &l, std::vector<std::pair<float, Loc
         Location rf{l.m_x + 1, l.m_y + 1, l.m_z};
         float rfCost = GlobalParam::gDiagonalCost;
 
-        if (this->cached_trace_cost_at(rf) == -1) {
+        if (ws.cached_trace_cost_at(rf) == -1) {
             //rfCost += sized_trace_cost_at(rf, traceSearchRadius);
-            rfCost += sized_trace_cost_at(rf, traceRelativeSearchGrids);
+            rfCost += sized_trace_cost_at(rf, curGridNetclass);
 
             // Incremental searching
             // rfCost += currentGridPenalty;
@@ -1195,9 +1625,9 @@ void BoardGrid::getNeighbors(const Location &l, std::vector<std::pair<float, Loc
             // rfCost -= sized_trace_cost_at(l, curGridNetclass.getTraceIncrementalSearchGrids().getRFDedGrids());
 
             // Put in cache
-            this->cached_trace_cost_set(rfCost - GlobalParam::gDiagonalCost, rf);
+            ws.cached_trace_cost_set(rfCost - GlobalParam::gDiagonalCost, rf);
         } else {
-            rfCost += this->cached_trace_cost_at(rf);
+            rfCost += ws.cached_trace_cost_at(rf);
         }
 
         ns.push_back(std::pair<float, Location>(rfCost, rf));
@@ -1208,9 +1638,9 @@ void BoardGrid::getNeighbors(const Location &l, std::vector<std::pair<float, Loc
         Location rb{l.m_x + 1, l.m_y - 1, l.m_z};
         float rbCost = GlobalParam::gDiagonalCost;
 
-        if (this->cached_trace_cost_at(rb) == -1) {
+        if (ws.cached_trace_cost_at(rb) == -1) {
             //rbCost += sized_trace_cost_at(rb, traceSearchRadius);
-            rbCost += sized_trace_cost_at(rb, traceRelativeSearchGrids);
+            rbCost += sized_trace_cost_at(rb, curGridNetclass);
 
             // Incremental searching
             // rbCost += currentGridPenalty;
@@ -1218,9 +1648,9 @@ void BoardGrid::getNeighbors(const Location &l, std::vector<std::pair<float, Loc
             // rbCost -= sized_trace_cost_at(l, curGridNetclass.getTraceIncrementalSearchGrids().getRBDedGrids());
 
             // Put in cache
-            this->cached_trace_cost_set(rbCost - GlobalParam::gDiagonalCost, rb);
+            ws.cached_trace_cost_set(rbCost - GlobalParam::gDiagonalCost, rb);
         } else {
-            rbCost += this->cached_trace_cost_at(rb);
+            rbCost += ws.cached_trace_cost_at(rb);
         }
 
         ns.push_back(std::pair<float, Location>(rbCost, rb));
@@ -1230,7 +1660,7 @@ void BoardGrid::getNeighbors(const Location &l, std::vector<std::pair<float, Loc
 void BoardGrid::printGnuPlot() {
     float max_val = 0.0;
     for (int i = 0; i < this->size; i += 1) {
-        if (this->grid[i].baseCost > max_val) max_val = this->grid[i].baseCost;
+        if (this->mBaseCost[i] > max_val) max_val = this->mBaseCost[i];
     }
 
     std::cout << "printGnuPlot()::Max Cost: " << max_val << std::endl;
@@ -1255,10 +1685,10 @@ void BoardGrid::printMatPlot(const std::string fileNameTag) {
     float maxCost = std::numeric_limits<float>::min();
     float minCost = std::numeric_limits<float>::max();
     for (int i = 0; i < this->size; i += 1) {
-        if (this->grid[i].baseCost > maxCost) {
-            maxCost = this->grid[i].baseCost;
-        } else if (this->grid[i].baseCost < minCost) {
-            minCost = this->grid[i].baseCost;
+        if (this->mBaseCost[i] > maxCost) {
+            maxCost = this->mBaseCost[i];
+        } else if (this->mBaseCost[i] < minCost) {
+            minCost = this->mBaseCost[i];
         }
     }
 
@@ -1318,7 +1748,7 @@ void BoardGrid::printMatPlot(const std::string fileNameTag) {
 
 //     float max_val = 0.0;
 //     for (int i = 0; i < this->size; i += 1) {
-//         if (this->grid[i].baseCost > max_val) max_val = this->grid[i].baseCost;
+//         if (this->mBaseCost[i] > max_val) max_val = this->mBaseCost[i];
 //     }
 
 //     for (int l = 0; l < this->l; l += 1) {
@@ -1366,19 +1796,21 @@ bool BoardGrid::sizedViaExpandableAndCost(const Location &l, const std::vector<P
     cost = 0.0;
     // Check through hole via
     for (int z = 0; z < this->l; ++z) {
+        const int layerOffset = z * this->w * this->h;
         for (const auto &gridPt : viaRelativeSearchGrids) {
-            Location current_l = Location(l.m_x + gridPt.x(), l.m_y + gridPt.y(), z);
-            if (!validate_location(current_l)) {
+            const int x = l.m_x + gridPt.x();
+            const int y = l.m_y + gridPt.y();
+            if (x < 0 || x >= this->w || y < 0 || y >= this->h) {
                 cost += GlobalParam::gViaTouchBoundaryCost;
                 continue;
             }
-            if (this->isViaForbidden(current_l)) {
+            const int id = x + y * this->w + layerOffset;
+            if (this->mCellType[id] == GridCellType::VIA_FORBIDDEN) {
                 //return false;
                 cost += GlobalParam::gViaForbiddenCost;
                 continue;
             }
-            //cost += this->via_cost_at(current_l);
-            cost += this->base_cost_at(current_l);
+            cost += this->mBaseCost[id];
         }
     }
     return true;
@@ -1390,18 +1822,21 @@ void BoardGrid::sizedViaCostBetweenStartEndLayer(const Location &l, const int st
     int end = std::max(startLayerId, endLayerId);
     // Check through hole via
     for (int z = start; z <= end; ++z) {
+        const int layerOffset = z * this->w * this->h;
         for (const auto &gridPt : viaRelativeSearchGrids) {
-            Location current_l = Location(l.m_x + gridPt.x(), l.m_y + gridPt.y(), z);
-            if (!validate_location(current_l)) {
+            const int x = l.m_x + gridPt.x();
+            const int y = l.m_y + gridPt.y();
+            if (x < 0 || x >= this->w || y < 0 || y >= this->h) {
                 cost += GlobalParam::gViaTouchBoundaryCost;
                 continue;
             }
-            if (this->isViaForbidden(current_l)) {
+            const int id = x + y * this->w + layerOffset;
+            if (this->mCellType[id] == GridCellType::VIA_FORBIDDEN) {
                 //return false;
                 cost += GlobalParam::gViaForbiddenCost;
                 continue;
             }
-            cost += this->base_cost_at(current_l);
+            cost += this->mBaseCost[id];
         }
     }
 }
@@ -1483,63 +1918,361 @@ bool BoardGrid::sizedViaExpandableAndIncrementalCost(const Location &curLoc, con
                 return false;
             }
         }
-        // LB
-        else if ((curLoc.m_x - prevLoc.m_x) == -1 && (curLoc.m_y - prevLoc.m_y) == -1) {
-            if (sizedViaExpandableAndCost(prevLoc, searchGrids.getLBAddGrids(), addCost)) {
-                cost += addCost;
-                if (sizedViaExpandableAndCost(prevLoc, searchGrids.getLBDedGrids(), dedCost)) {
-                    cost -= dedCost;
-                } else {
-                    std::cout << "!!!! LB: Errors, the deduction part has via forbidden flag !!!!" << std::endl;
+        // LB
+        else if ((curLoc.m_x - prevLoc.m_x) == -1 && (curLoc.m_y - prevLoc.m_y) == -1) {
+            if (sizedViaExpandableAndCost(prevLoc, searchGrids.getLBAddGrids(), addCost)) {
+                cost += addCost;
+                if (sizedViaExpandableAndCost(prevLoc, searchGrids.getLBDedGrids(), dedCost)) {
+                    cost -= dedCost;
+                } else {
+                    std::cout << "!!!! LB: Errors, the deduction part has via forbidden flag !!!!" << std::endl;
+                }
+            } else {
+                return false;
+            }
+        }
+        // RF
+        else if ((curLoc.m_x - prevLoc.m_x) == 1 && (curLoc.m_y - prevLoc.m_y) == 1) {
+            if (sizedViaExpandableAndCost(prevLoc, searchGrids.getRFAddGrids(), addCost)) {
+                cost += addCost;
+                if (sizedViaExpandableAndCost(prevLoc, searchGrids.getRFDedGrids(), dedCost)) {
+                    cost -= dedCost;
+                } else {
+                    std::cout << "!!!! RF: Errors, the deduction part has via forbidden flag !!!!" << std::endl;
+                }
+            } else {
+                return false;
+            }
+        }
+        // RB
+        else if ((curLoc.m_x - prevLoc.m_x) == 1 && (curLoc.m_y - prevLoc.m_y) == -1) {
+            if (sizedViaExpandableAndCost(prevLoc, searchGrids.getRBAddGrids(), addCost)) {
+                cost += addCost;
+                if (sizedViaExpandableAndCost(prevLoc, searchGrids.getRBDedGrids(), dedCost)) {
+                    cost -= dedCost;
+                } else {
+                    std::cout << "!!!! RB: Errors, the deduction part has via forbidden flag !!!!" << std::endl;
+                }
+            } else {
+                return false;
+            }
+        } else {
+            std::cout << __FUNCTION__ << "(): Cannot find the relationship between current and previous locaiton...." << std::endl;
+        }
+    }
+    return true;
+}
+
+float BoardGrid::sized_trace_cost_at(const Location &l, const std::vector<Point_2D<int>> &traRelativeSearchGrids) const {
+    float cost = 0.0;
+    // Stream through the base cost plane of the layer
+    const float *layerBaseCost = this->mBaseCost.data() + l.m_z * this->w * this->h;
+    for (const auto &gridPt : traRelativeSearchGrids) {
+        const int x = l.m_x + gridPt.x();
+        const int y = l.m_y + gridPt.y();
+        if (x < 0 || x >= this->w || y < 0 || y >= this->h) {
+            cost += GlobalParam::gTraceTouchBoundaryCost;
+            continue;
+        }
+        cost += layerBaseCost[x + y * this->w];
+    }
+    return cost;
+}
+
+float BoardGrid::sized_trace_cost_at(const Location &l, const GridNetclass &gridNetclass) const {
+    if (GlobalParam::gRowPrefixSumCost) {
+        return this->sizedTraceCostBySpans(l, gridNetclass.getTraceSearchingSpaceSpans());
+    }
+    return this->sized_trace_cost_at(l, gridNetclass.getTraceSearchingSpaceToGrids());
+}
+
+void BoardGrid::sizedViaCostBetweenStartEndLayer(const Location &l, const int startLayerId, const int endLayerId, const GridNetclass &gridNetclass, float &cost) const {
+    if (GlobalParam::gRowPrefixSumCost) {
+        cost = this->sizedViaCostBySpans(l, startLayerId, endLayerId, gridNetclass.getViaSearchingSpaceSpans());
+        return;
+    }
+    this->sizedViaCostBetweenStartEndLayer(l, startLayerId, endLayerId, gridNetclass.getViaSearchingSpaceToGrids(), cost);
+}
+
+float BoardGrid::sizedTraceCostBySpans(const Location &l, const std::vector<GridRowSpan> &spans) const {
+    if (this->mRowPrefixDirty.empty()) {
+        this->setupRowPrefixSums();
+    }
+    double cost = 0.0;
+    for (const auto &span : spans) {
+        const int y = l.m_y + span.y;
+        int xStart = l.m_x + span.xStart;
+        int xEnd = l.m_x + span.xEnd;
+        if (y < 0 || y >= this->h) {
+            cost += (xEnd - xStart + 1) * GlobalParam::gTraceTouchBoundaryCost;
+            continue;
+        }
+        if (xStart < 0) {
+            cost += -xStart * GlobalParam::gTraceTouchBoundaryCost;
+            xStart = 0;
+        }
+        if (xEnd >= this->w) {
+            cost += (xEnd - this->w + 1) * GlobalParam::gTraceTouchBoundaryCost;
+            xEnd = this->w - 1;
+        }
+        if (xStart > xEnd) continue;
+
+        const int rowId = y + l.m_z * this->h;
+        if (this->mRowPrefixDirty[rowId]) {
+            this->updateRowPrefixSums(rowId);
+        }
+        const double *rowPrefix = this->mBaseCostRowPrefix.data() + rowId * (this->w + 1);
+        cost += rowPrefix[xEnd + 1] - rowPrefix[xStart];
+    }
+    return (float)cost;
+}
+
+float BoardGrid::sizedViaCostBySpans(const Location &l, const int startLayerId, const int endLayerId, const std::vector<GridRowSpan> &spans) const {
+    if (this->mRowPrefixDirty.empty()) {
+        this->setupRowPrefixSums();
+    }
+    double cost = 0.0;
+    int start = std::min(startLayerId, endLayerId);
+    int end = std::max(startLayerId, endLayerId);
+    for (int z = start; z <= end; ++z) {
+        for (const auto &span : spans) {
+            const int y = l.m_y + span.y;
+            int xStart = l.m_x + span.xStart;
+            int xEnd = l.m_x + span.xEnd;
+            if (y < 0 || y >= this->h) {
+                cost += (xEnd - xStart + 1) * GlobalParam::gViaTouchBoundaryCost;
+                continue;
+            }
+            if (xStart < 0) {
+                cost += -xStart * GlobalParam::gViaTouchBoundaryCost;
+                xStart = 0;
+            }
+            if (xEnd >= this->w) {
+                cost += (xEnd - this->w + 1) * GlobalParam::gViaTouchBoundaryCost;
+                xEnd = this->w - 1;
+            }
+            if (xStart > xEnd) continue;
+
+            const int rowId = y + z * this->h;
+            if (this->mRowPrefixDirty[rowId]) {
+                this->updateRowPrefixSums(rowId);
+            }
+            const double *rowPrefix = this->mViaCostRowPrefix.data() + rowId * (this->w + 1);
+            cost += rowPrefix[xEnd + 1] - rowPrefix[xStart];
+        }
+    }
+    return (float)cost;
+}
+
+void BoardGrid::setupRowPrefixSums() const {
+    const int numRows = this->h * this->l;
+    this->mBaseCostRowPrefix.assign(numRows * (this->w + 1), 0.0);
+    this->mViaCostRowPrefix.assign(numRows * (this->w + 1), 0.0);
+    this->mRowPrefixDirty.assign(numRows, 1);
+}
+
+void BoardGrid::updateRowPrefixSums(const int rowId) const {
+    // rowId = y + z * h, the same as a cell id divided by w
+    const float *rowBaseCost = this->mBaseCost.data() + rowId * this->w;
+    const GridCellType *rowCellType = this->mCellType.data() + rowId * this->w;
+    double *basePrefix = this->mBaseCostRowPrefix.data() + rowId * (this->w + 1);
+    double *viaPrefix = this->mViaCostRowPrefix.data() + rowId * (this->w + 1);
+    basePrefix[0] = 0.0;
+    viaPrefix[0] = 0.0;
+    for (int x = 0; x < this->w; ++x) {
+        basePrefix[x + 1] = basePrefix[x] + rowBaseCost[x];
+        viaPrefix[x + 1] = viaPrefix[x] + (rowCellType[x] == GridCellType::VIA_FORBIDDEN ? GlobalParam::gViaForbiddenCost : rowBaseCost[x]);
+    }
+    this->mRowPrefixDirty[rowId] = 0;
+    ++this->mNumRowPrefixUpdates;
+}
+
+void BoardGrid::updateCostIndices() const {
+    if (GlobalParam::gHierarchicalSearch) {
+        this->updateCostPyramid();
+    }
+    if (!GlobalParam::gRowPrefixSumCost) {
+        return;
+    }
+    if (this->mRowPrefixDirty.empty()) {
+        this->setupRowPrefixSums();
+    }
+    for (int rowId = 0; rowId < static_cast<int>(this->mRowPrefixDirty.size()); ++rowId) {
+        if (this->mRowPrefixDirty[rowId]) {
+            this->updateRowPrefixSums(rowId);
+        }
+    }
+}
+
+void BoardGrid::markAllCostDirty() {
+    std::fill(this->mRowPrefixDirty.begin(), this->mRowPrefixDirty.end(), 1);
+    // Rebuilt on the next use
+    this->mCostPyramid.clear();
+    this->mCostPyramidDirty.clear();
+    this->mCostPyramidDirtyIds.clear();
+    for (auto &version : this->mCostTileVersion) {
+        ++version;
+    }
+}
+
+void BoardGrid::setupCostPyramid() const {
+    const int numLevels = std::max(static_cast<int>(GlobalParam::gHierarchicalSearchLevel), 1);
+    this->mCostPyramid.assign(numLevels, std::vector<float>());
+    this->mCostPyramidW.assign(numLevels, 0);
+    this->mCostPyramidH.assign(numLevels, 0);
+    for (int level = 1; level <= numLevels; ++level) {
+        const int cellSize = 1 << level;
+        this->mCostPyramidW[level - 1] = (this->w + cellSize - 1) / cellSize;
+        this->mCostPyramidH[level - 1] = (this->h + cellSize - 1) / cellSize;
+        this->mCostPyramid[level - 1].assign(this->mCostPyramidW[level - 1] * this->mCostPyramidH[level - 1] * this->l, 0.0);
+    }
+
+    // Level 1 from the grid cells, then each level from the one below
+    for (int z = 0; z < this->l; ++z) {
+        for (int y = 0; y < this->h; ++y) {
+            for (int x = 0; x < this->w; ++x) {
+                this->mCostPyramid[0][x / 2 + (y / 2) * this->mCostPyramidW[0] + z * this->mCostPyramidW[0] * this->mCostPyramidH[0]] +=
+                    this->mBaseCost[x + y * this->w + z * this->w * this->h];
+            }
+        }
+    }
+    for (int level = 2; level <= numLevels; ++level) {
+        const int childW = this->mCostPyramidW[level - 2];
+        const int childH = this->mCostPyramidH[level - 2];
+        const int levelW = this->mCostPyramidW[level - 1];
+        const int levelH = this->mCostPyramidH[level - 1];
+        for (int z = 0; z < this->l; ++z) {
+            for (int y = 0; y < childH; ++y) {
+                for (int x = 0; x < childW; ++x) {
+                    this->mCostPyramid[level - 1][x / 2 + (y / 2) * levelW + z * levelW * levelH] += this->mCostPyramid[level - 2][x + y * childW + z * childW * childH];
                 }
-            } else {
-                return false;
             }
         }
-        // RF
-        else if ((curLoc.m_x - prevLoc.m_x) == 1 && (curLoc.m_y - prevLoc.m_y) == 1) {
-            if (sizedViaExpandableAndCost(prevLoc, searchGrids.getRFAddGrids(), addCost)) {
-                cost += addCost;
-                if (sizedViaExpandableAndCost(prevLoc, searchGrids.getRFDedGrids(), dedCost)) {
-                    cost -= dedCost;
-                } else {
-                    std::cout << "!!!! RF: Errors, the deduction part has via forbidden flag !!!!" << std::endl;
-                }
-            } else {
-                return false;
+    }
+
+    this->mCostPyramidDirty.assign(this->mCostPyramid[0].size(), 0);
+    this->mCostPyramidDirtyIds.clear();
+}
+
+void BoardGrid::updateCostPyramid() const {
+    if (this->mCostPyramid.size() != std::max(GlobalParam::gHierarchicalSearchLevel, 1u)) {
+        this->setupCostPyramid();
+        return;
+    }
+    if (this->mCostPyramidDirtyIds.empty()) {
+        return;
+    }
+
+    // Level 1 blocks from the grid cells
+    std::vector<int> cellIds;
+    cellIds.swap(this->mCostPyramidDirtyIds);
+    const int blockW = this->mCostPyramidW[0];
+    const int blockH = this->mCostPyramidH[0];
+    for (const int blockId : cellIds) {
+        this->mCostPyramidDirty[blockId] = 0;
+        const int bx = blockId % blockW;
+        const int by = (blockId / blockW) % blockH;
+        const int z = blockId / (blockW * blockH);
+        float sum = 0.0;
+        for (int y = 2 * by; y < std::min(2 * by + 2, this->h); ++y) {
+            for (int x = 2 * bx; x < std::min(2 * bx + 2, this->w); ++x) {
+                sum += this->mBaseCost[x + y * this->w + z * this->w * this->h];
             }
         }
-        // RB
-        else if ((curLoc.m_x - prevLoc.m_x) == 1 && (curLoc.m_y - prevLoc.m_y) == -1) {
-            if (sizedViaExpandableAndCost(prevLoc, searchGrids.getRBAddGrids(), addCost)) {
-                cost += addCost;
-                if (sizedViaExpandableAndCost(prevLoc, searchGrids.getRBDedGrids(), dedCost)) {
-                    cost -= dedCost;
-                } else {
-                    std::cout << "!!!! RB: Errors, the deduction part has via forbidden flag !!!!" << std::endl;
+        this->mCostPyramid[0][blockId] = sum;
+    }
+    this->mNumCostPyramidUpdates += cellIds.size();
+
+    // Then the parents of the updated cells, level by level
+    for (int level = 2; level <= static_cast<int>(this->mCostPyramid.size()); ++level) {
+        const int childW = this->mCostPyramidW[level - 2];
+        const int childH = this->mCostPyramidH[level - 2];
+        const int levelW = this->mCostPyramidW[level - 1];
+        const int levelH = this->mCostPyramidH[level - 1];
+        for (auto &id : cellIds) {
+            const int z = id / (childW * childH);
+            id = (id % childW) / 2 + ((id / childW) % childH / 2) * levelW + z * levelW * levelH;
+        }
+        std::sort(cellIds.begin(), cellIds.end());
+        cellIds.erase(std::unique(cellIds.begin(), cellIds.end()), cellIds.end());
+
+        for (const int id : cellIds) {
+            const int x = id % levelW;
+            const int y = (id / levelW) % levelH;
+            const int z = id / (levelW * levelH);
+            float sum = 0.0;
+            for (int cy = 2 * y; cy < std::min(2 * y + 2, childH); ++cy) {
+                for (int cx = 2 * x; cx < std::min(2 * x + 2, childW); ++cx) {
+                    sum += this->mCostPyramid[level - 2][cx + cy * childW + z * childW * childH];
                 }
-            } else {
-                return false;
             }
-        } else {
-            std::cout << __FUNCTION__ << "(): Cannot find the relationship between current and previous locaiton...." << std::endl;
+            this->mCostPyramid[level - 1][id] = sum;
         }
     }
-    return true;
 }
 
-float BoardGrid::sized_trace_cost_at(const Location &l, const std::vector<Point_2D<int>> &traRelativeSearchGrids) const {
-    float cost = 0.0;
-    for (const auto &gridPt : traRelativeSearchGrids) {
-        Location current_l = Location(l.m_x + gridPt.x(), l.m_y + gridPt.y(), l.m_z);
-        if (!validate_location(current_l)) {
-            cost += GlobalParam::gTraceTouchBoundaryCost;
-            continue;
+void BoardGrid::markCostPyramidDirty(const int id) {
+    const int x = id % this->w;
+    const int y = (id / this->w) % this->h;
+    const int z = id / (this->w * this->h);
+    const int blockId = x / 2 + (y / 2) * this->mCostPyramidW[0] + z * this->mCostPyramidW[0] * this->mCostPyramidH[0];
+    if (!this->mCostPyramidDirty[blockId]) {
+        this->mCostPyramidDirty[blockId] = 1;
+        this->mCostPyramidDirtyIds.push_back(blockId);
+    }
+}
+
+void BoardGrid::setupSearchWorkspace(SearchWorkspace &ws) const {
+    ws.setup(this->w, this->h, this->l);
+    if ((!GlobalParam::gPersistentViaCost && !GlobalParam::gPersistentTraceCost) || this->mGridNetclasses.empty()) {
+        ws.clearCostCaches();
+        return;
+    }
+    if (this->mCostTileVersion.empty() || this->mCostTileSize != GlobalParam::gCostCacheTileSize ||
+        this->mNumCostTileNetclasses != static_cast<int>(this->mGridNetclasses.size())) {
+        this->setupCostTiles();
+    }
+    ws.setupCostCaches(this->mGridNetclasses.size(), GlobalParam::gPersistentViaCost, GlobalParam::gPersistentTraceCost,
+                       this->mCostTileSize, this->mNumCostTilesX, this->mNumCostTilesY, &this->mCostTileVersion);
+}
+
+void BoardGrid::setupCostTiles() const {
+    if (!this->mCostTileVersion.empty() && this->mCostTileSize == GlobalParam::gCostCacheTileSize) {
+        // Same tiles but new netclasses, the cached tiles of the workspaces are all stale
+        for (auto &version : this->mCostTileVersion) {
+            ++version;
+        }
+    } else {
+        this->mCostTileSize = GlobalParam::gCostCacheTileSize;
+        this->mNumCostTilesX = (this->w + this->mCostTileSize - 1) / this->mCostTileSize;
+        this->mNumCostTilesY = (this->h + this->mCostTileSize - 1) / this->mCostTileSize;
+        this->mCostTileVersion.assign(this->mNumCostTilesX * this->mNumCostTilesY, 0);
+    }
+    this->mNumCostTileNetclasses = this->mGridNetclasses.size();
+
+    // A cost is stale if any grid in its searching space is changed
+    this->mCostTileRadius = 0;
+    for (const auto &gridNetclass : this->mGridNetclasses) {
+        for (const auto *grids : {&gridNetclass.getViaSearchingSpaceToGrids(), &gridNetclass.getTraceSearchingSpaceToGrids()}) {
+            for (const auto &pt : *grids) {
+                this->mCostTileRadius = std::max(this->mCostTileRadius, std::max(abs(pt.x()), abs(pt.y())));
+            }
+        }
+    }
+}
+
+void BoardGrid::markCostTilesDirty(const int id) {
+    const int x = id % this->w;
+    const int y = (id / this->w) % this->h;
+    const int tileXStart = std::max(x - this->mCostTileRadius, 0) / this->mCostTileSize;
+    const int tileXEnd = std::min(x + this->mCostTileRadius, this->w - 1) / this->mCostTileSize;
+    const int tileYStart = std::max(y - this->mCostTileRadius, 0) / this->mCostTileSize;
+    const int tileYEnd = std::min(y + this->mCostTileRadius, this->h - 1) / this->mCostTileSize;
+    for (int tileY = tileYStart; tileY <= tileYEnd; ++tileY) {
+        for (int tileX = tileXStart; tileX <= tileXEnd; ++tileX) {
+            ++this->mCostTileVersion[tileX + tileY * this->mNumCostTilesX];
         }
-        cost += this->base_cost_at(current_l);
-        // cost += this->via_cost_at(current_l);
     }
-    return cost;
 }
 
 float BoardGrid::sized_trace_cost_at(const Location &l, int traceRadius) const {
@@ -1617,7 +2350,8 @@ void BoardGrid::add_via_cost(const Location &l, const int layer, const float cos
             assert(((l.m_x + x) + (l.m_y + y) * this->w + (layer) * this->w * this->h) < this->size);
 #endif
             //this->grid[(l.m_x + x) + (l.m_y + y) * this->w + (layer) * this->w * this->h].viaCost += cost;
-            this->grid[(l.m_x + x) + (l.m_y + y) * this->w + (layer) * this->w * this->h].baseCost += cost;
+            const int id = (l.m_x + x) + (l.m_y + y) * this->w + (layer) * this->w * this->h;
+            this->addBaseCostDelta(id, cost);
         }
     }
 }
@@ -1628,26 +2362,65 @@ void BoardGrid::add_via_cost(const Location &l, const int layer, const float cos
         assert(((l.m_x + relativePt.x()) + (l.m_y + relativePt.y()) * this->w + (layer) * this->w * this->h) < this->size);
 #endif
         //this->grid[(l.m_x + relativePt.x()) + (l.m_y + relativePt.y()) * this->w + (layer) * this->w * this->h].viaCost += cost;
-        this->grid[(l.m_x + relativePt.x()) + (l.m_y + relativePt.y()) * this->w + (layer) * this->w * this->h].baseCost += cost;
+        const int id = (l.m_x + relativePt.x()) + (l.m_y + relativePt.y()) * this->w + (layer) * this->w * this->h;
+        this->addBaseCostDelta(id, cost);
     }
 }
 
 void BoardGrid::remove_route_from_base_cost(const MultipinRoute &route) {
-    auto &curGridNetclass = mGridNetclasses.at(route.getGridNetclassId());
-    int traceExpandingRadius = curGridNetclass.getTraceExpansion();
-    int traceDiagonalExpandingRadius = curGridNetclass.getDiagonalTraceExpansion();
-    int viaExpandingRadius = curGridNetclass.getViaExpansion();
-
-    // Old API below
-    // add_route_to_base_cost(route, traceExpandingRadius, -GlobalParam::gTraceBasicCost, viaExpandingRadius, -GlobalParam::gViaInsertionCost);
+    auto ripupStart = std::chrono::steady_clock::now();
+
+    auto journalIte = this->mBaseCostJournals.find(route.getNetId());
+    if (journalIte != this->mBaseCostJournals.end() && !journalIte->second.empty()) {
+        // Replay the recorded deltas negated
+        this->applyBaseCostJournal(journalIte->second.back(), true);
+        if (this->isInTransaction()) {
+            this->mJournalUndoLog.push_back(JournalUndoEntry{route.getNetId(), false, std::move(journalIte->second.back())});
+        }
+        journalIte->second.pop_back();
+        if (journalIte->second.empty()) {
+            this->mBaseCostJournals.erase(journalIte);
+        }
+        ++this->mNumJournalRipups;
+        this->mJournalRipupTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - ripupStart).count();
+    } else {
+        this->addRouteGridPathsToBaseCost(route, true);
+        ++this->mNumRasterRipups;
+        this->mRasterRipupTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - ripupStart).count();
+    }
 
-    for (const auto &path : route.getGridPaths()) {
-        addGridPathToBaseCost(path, route.getGridNetclassId(), traceExpandingRadius, traceDiagonalExpandingRadius,
-                              route.getCurNegTrackObstacleCost(), viaExpandingRadius, route.getCurNegViaObstacleCost());
+    if (isTrackingOccupancy()) {
+        this->addRouteOccupancy(route, -1);
     }
 }
 
 void BoardGrid::add_route_to_base_cost(const MultipinRoute &route) {
+    if (GlobalParam::gBaseCostJournal) {
+        // Rasterize into the recorder, then apply the compacted journal
+        std::vector<std::pair<int, float> > deltas;
+        this->mBaseCostRecorder = &deltas;
+        this->addRouteGridPathsToBaseCost(route, false);
+        this->mBaseCostRecorder = nullptr;
+
+        BaseCostJournal journal;
+        journal.build(deltas);
+        this->applyBaseCostJournal(journal, false);
+        ++this->mNumJournals;
+        this->mJournalBytes += journal.getMemoryBytes();
+        this->mBaseCostJournals[route.getNetId()].push_back(std::move(journal));
+        if (this->isInTransaction()) {
+            this->mJournalUndoLog.push_back(JournalUndoEntry{route.getNetId(), true, BaseCostJournal()});
+        }
+    } else {
+        this->addRouteGridPathsToBaseCost(route, false);
+    }
+
+    if (isTrackingOccupancy()) {
+        this->addRouteOccupancy(route, 1);
+    }
+}
+
+void BoardGrid::addRouteGridPathsToBaseCost(const MultipinRoute &route, const bool negate) {
     auto &curGridNetclass = mGridNetclasses.at(route.getGridNetclassId());
     int traceExpandingRadius = curGridNetclass.getTraceExpansion();
     int traceDiagonalExpandingRadius = curGridNetclass.getDiagonalTraceExpansion();
@@ -1656,9 +2429,91 @@ void BoardGrid::add_route_to_base_cost(const MultipinRoute &route) {
     // Old API below
     // add_route_to_base_cost(route, traceExpandingRadius, GlobalParam::gTraceBasicCost, viaExpandingRadius, GlobalParam::gViaInsertionCost);
 
+    float traceCost = negate ? route.getCurNegTrackObstacleCost() : route.getCurTrackObstacleCost();
+    float viaCost = negate ? route.getCurNegViaObstacleCost() : route.getCurViaObstacleCost();
     for (const auto &path : route.getGridPaths()) {
         addGridPathToBaseCost(path, route.getGridNetclassId(), traceExpandingRadius, traceDiagonalExpandingRadius,
-                              route.getCurTrackObstacleCost(), viaExpandingRadius, route.getCurViaObstacleCost());
+                              traceCost, viaExpandingRadius, viaCost);
+    }
+}
+
+void BoardGrid::beginTransaction() {
+    this->mTransactionMarkers.push_back(TransactionMarker{this->mBaseCostUndoLog.size(), this->mCellTypeUndoLog.size(),
+                                                          this->mNumTracesUndoLog.size(), this->mHistoryCongestionUndoLog.size(),
+                                                          this->mJournalUndoLog.size(), this->mPresentCongestionFactor});
+}
+
+void BoardGrid::commitTransaction() {
+    if (this->mTransactionMarkers.empty()) {
+        std::cerr << __FUNCTION__ << "(): No transaction to commit" << std::endl;
+        return;
+    }
+    this->mTransactionMarkers.pop_back();
+    // The changes stay in the log of the enclosing transaction, if any
+    if (this->mTransactionMarkers.empty()) {
+        this->mBaseCostUndoLog.clear();
+        this->mCellTypeUndoLog.clear();
+        this->mNumTracesUndoLog.clear();
+        this->mHistoryCongestionUndoLog.clear();
+        this->mJournalUndoLog.clear();
+    }
+}
+
+void BoardGrid::rollbackTransaction() {
+    if (this->mTransactionMarkers.empty()) {
+        std::cerr << __FUNCTION__ << "(): No transaction to roll back" << std::endl;
+        return;
+    }
+    const TransactionMarker marker = this->mTransactionMarkers.back();
+    this->mTransactionMarkers.pop_back();
+
+    // Restore the old values in reverse order, so a cell ends up with its value at beginTransaction()
+    for (std::size_t i = this->mBaseCostUndoLog.size(); i-- > marker.numBaseCostChanges;) {
+        const auto &change = this->mBaseCostUndoLog[i];
+        this->mBaseCost[change.first] = change.second;
+        this->markCostDirty(change.first);
+    }
+    this->mBaseCostUndoLog.resize(marker.numBaseCostChanges);
+    for (std::size_t i = this->mCellTypeUndoLog.size(); i-- > marker.numCellTypeChanges;) {
+        const auto &change = this->mCellTypeUndoLog[i];
+        this->mCellType[change.first] = change.second;
+        this->markCostDirty(change.first);
+    }
+    this->mCellTypeUndoLog.resize(marker.numCellTypeChanges);
+    for (std::size_t i = this->mNumTracesUndoLog.size(); i-- > marker.numNumTracesChanges;) {
+        const auto &change = this->mNumTracesUndoLog[i];
+        this->mNumTraces[change.first] = change.second;
+    }
+    this->mNumTracesUndoLog.resize(marker.numNumTracesChanges);
+    for (std::size_t i = this->mHistoryCongestionUndoLog.size(); i-- > marker.numHistoryCongestionChanges;) {
+        const auto &change = this->mHistoryCongestionUndoLog[i];
+        this->mHistoryCongestionCost[change.first] = change.second;
+    }
+    this->mHistoryCongestionUndoLog.resize(marker.numHistoryCongestionChanges);
+    this->mPresentCongestionFactor = marker.presentCongestionFactor;
+    for (std::size_t i = this->mJournalUndoLog.size(); i-- > marker.numJournalChanges;) {
+        auto &change = this->mJournalUndoLog[i];
+        auto &journals = this->mBaseCostJournals[change.netId];
+        if (change.pushed) {
+            journals.pop_back();
+        } else {
+            journals.push_back(std::move(change.journal));
+        }
+        if (journals.empty()) {
+            this->mBaseCostJournals.erase(change.netId);
+        }
+    }
+    this->mJournalUndoLog.erase(this->mJournalUndoLog.begin() + marker.numJournalChanges, this->mJournalUndoLog.end());
+}
+
+void BoardGrid::applyBaseCostJournal(const BaseCostJournal &journal, const bool negate) {
+    for (const auto &run : journal.getRuns()) {
+        const float delta = negate ? -run.delta : run.delta;
+        for (int id = run.cellId; id < run.cellId + run.length; ++id) {
+            this->logBaseCostChange(id);
+            this->mBaseCost[id] += delta;
+            this->markCostDirty(id);
+        }
     }
 }
 
@@ -1705,6 +2560,121 @@ void BoardGrid::add_route_to_base_cost(const MultipinRoute &route, const int tra
     }
 }
 
+void BoardGrid::getRouteOccupiedGridCells(const MultipinRoute &route, std::vector<int> &cellIds) const {
+    cellIds.clear();
+    if (route.getGridPaths().empty()) {
+        return;
+    }
+    const auto &gridNetclass = this->mGridNetclasses.at(route.getGridNetclassId());
+    // Copper shapes inflated by half of the clearance, two nets overlap if they're too close
+    const int halfClearance = (gridNetclass.getClearance() + 1) / 2;
+    const int traceRadius = gridNetclass.getHalfTraceWidth() + halfClearance;
+    const int viaRadius = (GlobalParam::gUseMircoVia ? gridNetclass.getHalfMicroViaDia() : gridNetclass.getHalfViaDia()) + halfClearance;
+
+    auto addDisk = [this, &cellIds](const int x, const int y, const int z, const int radius) {
+        for (int dy = -radius; dy <= radius; ++dy) {
+            for (int dx = -radius; dx <= radius; ++dx) {
+                if (dx * dx + dy * dy > radius * radius) continue;
+                Location loc{x + dx, y + dy, z};
+                if (this->validate_location(loc)) {
+                    cellIds.push_back(this->locationToId(loc));
+                }
+            }
+        }
+    };
+
+    for (const auto &path : route.getGridPaths()) {
+        const auto locations = path.getCells();
+        for (auto ite = locations.begin(); ite != locations.end(); ++ite) {
+            addDisk(ite->m_x, ite->m_y, ite->m_z, traceRadius);
+
+            auto nextIte = std::next(ite);
+            if (nextIte != locations.end() && nextIte->m_x == ite->m_x && nextIte->m_y == ite->m_y && nextIte->m_z != ite->m_z) {
+                // A via
+                int startLayer = 0;
+                int endLayer = this->l - 1;
+                if (GlobalParam::gUseMircoVia) {
+                    startLayer = std::min(ite->m_z, nextIte->m_z);
+                    endLayer = std::max(ite->m_z, nextIte->m_z);
+                }
+                for (int z = startLayer; z <= endLayer; ++z) {
+                    addDisk(ite->m_x, ite->m_y, z, viaRadius);
+                }
+            }
+        }
+    }
+
+    // A net occupies a cell once
+    std::sort(cellIds.begin(), cellIds.end());
+    cellIds.erase(std::unique(cellIds.begin(), cellIds.end()), cellIds.end());
+}
+
+void BoardGrid::addRouteOccupancy(const MultipinRoute &route, const int value) {
+    std::vector<int> cellIds;
+    this->getRouteOccupiedGridCells(route, cellIds);
+    for (const auto id : cellIds) {
+        this->logNumTracesChange(id);
+        this->mNumTraces[id] += value;
+    }
+}
+
+bool BoardGrid::isRouteCongested(const MultipinRoute &route) const {
+    std::vector<int> cellIds;
+    this->getRouteOccupiedGridCells(route, cellIds);
+    for (const auto id : cellIds) {
+        if (this->mNumTraces[id] > 1) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void BoardGrid::getCongestionNeighborhood(const int margin, std::vector<char> &cellFlags) const {
+    cellFlags.assign(this->size, 0);
+    Location loc;
+    for (int id = 0; id < this->size; ++id) {
+        if (this->mNumTraces[id] <= 1) continue;
+        this->idToLocation(id, loc);
+        for (int y = std::max(loc.m_y - margin, 0); y <= std::min(loc.m_y + margin, this->h - 1); ++y) {
+            for (int x = std::max(loc.m_x - margin, 0); x <= std::min(loc.m_x + margin, this->w - 1); ++x) {
+                cellFlags[this->locationToId(Location{x, y, loc.m_z})] = 1;
+            }
+        }
+    }
+}
+
+bool BoardGrid::isRouteInFlaggedCells(const MultipinRoute &route, const std::vector<char> &cellFlags) const {
+    std::vector<int> cellIds;
+    this->getRouteOccupiedGridCells(route, cellIds);
+    for (const auto id : cellIds) {
+        if (cellFlags[id]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int BoardGrid::getOverflow(int &numCongestedCells) const {
+    int overflow = 0;
+    numCongestedCells = 0;
+    for (int i = 0; i < this->size; ++i) {
+        if (this->mNumTraces[i] > 1) {
+            overflow += this->mNumTraces[i] - 1;
+            ++numCongestedCells;
+        }
+    }
+    return overflow;
+}
+
+void BoardGrid::updateHistoryCongestionCost(const float increment) {
+    for (int i = 0; i < this->size; ++i) {
+        if (this->mNumTraces[i] > 1) {
+            this->logHistoryCongestionChange(i);
+            this->mHistoryCongestionCost[i] += increment * (this->mNumTraces[i] - 1);
+        }
+    }
+}
+
 void BoardGrid::getCostsVecByRadius(const float centerCost, const int radius, vector<float> &costVec) {
     costVec.clear();
     costVec.resize(radius + 1, centerCost);
@@ -1970,11 +2940,11 @@ void BoardGrid::addGridPathToBaseCost(const GridPath &path, const int gridNetcla
 //     std::cout << "Finished came_from_to_features ID" << std::endl;
 // }
 
-void BoardGrid::backtrackingToGridPath(const Location &end, MultipinRoute &route) const {
-    std::cout << __FUNCTION__ << ": Starting backtracking and create new GridPath from Location: " << end << std::endl;
+void BoardGrid::backtrackingToGridPath(const SearchWorkspace &ws, const Location &end, MultipinRoute &route) const {
+    ws.log() << __FUNCTION__ << ": Starting backtracking and create new GridPath from Location: " << end << std::endl;
 
     if (!this->validate_location(end)) {
-        std::cout << __FUNCTION__ << "Bad final end" << std::endl;
+        ws.log() << __FUNCTION__ << "Bad final end" << std::endl;
     }
 
     GridPath &gp = route.getNewGridPath();
@@ -1983,7 +2953,7 @@ void BoardGrid::backtrackingToGridPath(const Location &end, MultipinRoute &route
     // features.push_back(end);
     Location current = end;
     int currentId = this->locationToId(current);
-    int nextId = this->getCameFromId(currentId);
+    int nextId = ws.getCameFromId(currentId);
 
     while (nextId != -1) {
         if (nextId == currentId) {
@@ -1997,10 +2967,50 @@ void BoardGrid::backtrackingToGridPath(const Location &end, MultipinRoute &route
 
         gp.addLocation(next);
         currentId = nextId;
-        nextId = this->getCameFromId(currentId);
+        nextId = ws.getCameFromId(currentId);
+    }
+
+    ws.log() << __FUNCTION__ << ": End of backtracking and create new GridPath" << std::endl;
+}
+
+void BoardGrid::backtrackingToGridPathSegments(const SearchWorkspace &ws, const Location &end, MultipinRoute &route) const {
+    ws.log() << __FUNCTION__ << ": Starting backtracking and create new GridPath from Location: " << end << std::endl;
+
+    if (!this->validate_location(end)) {
+        ws.log() << __FUNCTION__ << "Bad final end" << std::endl;
+    }
+
+    GridPath &gp = route.getNewGridPath();
+    auto &segs = gp.setSegments();
+
+    segs.emplace_back(end);
+    Location current = end;
+    Location prevStep{0, 0, 0};
+    int currentId = this->locationToId(current);
+    int nextId = ws.getCameFromId(currentId);
+
+    while (nextId != -1) {
+        if (nextId == currentId) {
+            break;
+        }
+
+        Location next;
+        this->idToLocation(nextId, next);
+
+        // Same step as the previous one, the last point is not a corner (as in GridPath::removeRedundantPoints())
+        Location step{next.m_x - current.m_x, next.m_y - current.m_y, next.m_z - current.m_z};
+        if (segs.size() >= 2 && step == prevStep) {
+            segs.back() = next;
+        } else {
+            segs.emplace_back(next);
+        }
+        prevStep = step;
+        current = next;
+        currentId = nextId;
+        nextId = ws.getCameFromId(currentId);
     }
 
-    std::cout << __FUNCTION__ << ": End of backtracking and create new GridPath" << std::endl;
+    ws.log() << __FUNCTION__ << ": End of backtracking and create new GridPath, # segment points: " << segs.size() << std::endl;
 }
 
 // std::vector<Location> BoardGrid::came_from_to_features(
@@ -2154,38 +3164,33 @@ void BoardGrid::routeGridDiffPairNet(GridDiffPairNet &route) {
     //       Step 1
     //========================================
     // Clear and initialize
-    this->setCurrentGridNetclassId(route.getGridNetclassId());
-    this->clearAllCameFromId();
-    this->cached_trace_cost_fill(-1);
-    this->cached_via_cost_fill(-1);
+    SearchWorkspace &ws = this->mWorkspace;
+    this->setupSearchWorkspace(ws);
+    ws.setCurrentGridNetclassId(route.getGridNetclassId());
+    ws.resetCachedCostsForNewRoute();
     route.currentRouteCost = 0.0;
     bool allowViaForRouting = GlobalParam::gAllowViaForRouting;
     GlobalParam::gAllowViaForRouting = false;
 
     for (size_t i = 1; i < route.mGridPins.size(); ++i) {
-        // For early break
-        this->setTargetedPins(route.mGridPins.at(i).pinWithLayers);
-        // For 2D cost estimation (cares about x and y only)
-        current_targeted_pin = route.mGridPins.at(i).pinWithLayers.front();
-        // For 3D cost estimation
-        currentTargetedPinWithLayers = route.mGridPins.at(i).pinWithLayers;
+        // For early break and the cost estimation
+        ws.setCurrentTargets(route.mGridPins.at(i).pinWithLayers);
 
         Location finalEnd{0, 0, 0};
         float routeCost = 0.0;
 
-        this->aStarSearching(dynamic_cast<MultipinRoute &>(route), finalEnd, routeCost);
+        this->aStarSearching(ws, dynamic_cast<MultipinRoute &>(route), finalEnd, routeCost);
         route.currentRouteCost += routeCost;
 
         // TODO Fix this, when THROUGH PAD as a start?
-        this->backtrackingToGridPath(finalEnd, dynamic_cast<MultipinRoute &>(route));
+        if (GlobalParam::gBacktrackToSegments) {
+            this->backtrackingToGridPathSegments(ws, finalEnd, dynamic_cast<MultipinRoute &>(route));
+        } else {
+            this->backtrackingToGridPath(ws, finalEnd, dynamic_cast<MultipinRoute &>(route));
+        }
 
         // Reset temporary stuff
-        // For early break
-        this->clearTargetedPins(route.mGridPins.at(i).pinWithLayers);
-        // For 2D cost estimation
-        current_targeted_pin = Location{0, 0, 0};
-        // For 3D cost estimation
-        currentTargetedPinWithLayers.clear();
+        ws.clearCurrentTargets();
     }
     // Put back default setting
     GlobalParam::gAllowViaForRouting = allowViaForRouting;
@@ -2238,10 +3243,10 @@ void BoardGrid::routeGridNetWithRoutedGridPaths(MultipinRoute &route, const bool
     std::cout << __FUNCTION__ << "(): netId: " << route.getNetId() << ", route.gridPins.size: " << route.mGridPins.size() << std::endl;
 
     // Clear and initialize
-    this->setCurrentGridNetclassId(route.getGridNetclassId());
-    this->clearAllCameFromId();
-    this->cached_trace_cost_fill(-1);
-    this->cached_via_cost_fill(-1);
+    SearchWorkspace &ws = this->mWorkspace;
+    this->setupSearchWorkspace(ws);
+    ws.setCurrentGridNetclassId(route.getGridNetclassId());
+    ws.resetCachedCostsForNewRoute();
     route.currentRouteCost = 0.0;
 
     // Remove GridPin's obstacle costs
@@ -2250,30 +3255,21 @@ void BoardGrid::routeGridNetWithRoutedGridPaths(MultipinRoute &route, const bool
     }
 
     for (size_t i = 0; i < route.mGridPins.size(); ++i) {
-        // For early break
-        this->setTargetedPins(route.mGridPins.at(i).pinWithLayers);
-        // For 2D cost estimation (cares about x and y only)
-        current_targeted_pin = route.mGridPins.at(i).pinWithLayers.front();
-        // For 3D cost estimation
-        currentTargetedPinWithLayers = route.mGridPins.at(i).pinWithLayers;
+        // For early break and the cost estimation
+        ws.setCurrentTargets(route.mGridPins.at(i).pinWithLayers);
 
         Location finalEnd{0, 0, 0};
         float routeCost = 0.0;
 
         // GridPin.front() will be initilized inside
-        this->aStarSearching(route, finalEnd, routeCost);
+        this->aStarSearching(ws, route, finalEnd, routeCost);
         route.currentRouteCost += routeCost;
 
         // TODO Fix this, when THROUGH PAD as a start?
-        this->backtrackingToGridPath(finalEnd, route);
+        this->backtrackingToGridPath(ws, finalEnd, route);
 
         // Reset temporary stuff
-        // For early break
-        this->clearTargetedPins(route.mGridPins.at(i).pinWithLayers);
-        // For 2D cost estimation
-        current_targeted_pin = Location{0, 0, 0};
-        // For 3D cost estimation
-        currentTargetedPinWithLayers.clear();
+        ws.clearCurrentTargets();
     }
 
     // Put back GridPin's obstacle costs
@@ -2293,53 +3289,244 @@ void BoardGrid::routeGridNetFromScratch(MultipinRoute &route, const bool removeG
 
     if (route.mGridPins.size() <= 1) return;
 
-    // Clear and initialize
-    this->setCurrentGridNetclassId(route.getGridNetclassId());
-    this->clearAllCameFromId();
-    this->cached_trace_cost_fill(-1);
-    this->cached_via_cost_fill(-1);
-    route.currentRouteCost = 0.0;
-
     // Remove GridPin's obstacle costs
     if (removeGridPinObstacles) {
         this->addPinShapeObstacleCostToGrid(route.mGridPins, -GlobalParam::gPinObstacleCost, true, false, true);
     }
 
-    for (size_t i = 1; i < route.mGridPins.size(); ++i) {
-        // For early break
-        this->setTargetedPins(route.mGridPins.at(i).pinWithLayers);
-        // For 2D cost estimation (cares about x and y only)
-        current_targeted_pin = route.mGridPins.at(i).pinWithLayers.front();
-        // For 3D cost estimation
-        currentTargetedPinWithLayers = route.mGridPins.at(i).pinWithLayers;
+    this->setupSearchWorkspace(this->mWorkspace);
+    this->searchGridNetFromScratch(this->mWorkspace, route);
+
+    // Put back GridPin's obstacle costs
+    if (removeGridPinObstacles) {
+        this->addPinShapeObstacleCostToGrid(route.mGridPins, GlobalParam::gPinObstacleCost, true, false, true);
+    }
+
+    // Convert from grid locations to grid paths
+    route.gridPathLocationsToSegments();
+    this->add_route_to_base_cost(route);
+}
+
+bool BoardGrid::searchGridNetFromScratch(SearchWorkspace &ws, MultipinRoute &route) const {
+    // Clear and initialize
+    ws.setCurrentGridNetclassId(route.getGridNetclassId());
+    ws.resetCachedCostsForNewRoute();
+    route.currentRouteCost = 0.0;
 
+    if (GlobalParam::gMultiTerminalSearch) {
+        return this->growSearchTree(ws, route);
+    }
+
+    // Keep the searches in the net's global routing corridor
+    if (GlobalParam::gGlobalRouting && !route.getSearchCorridor().empty()) {
+        ws.setSearchCorridor(route.getSearchCorridor(), GlobalParam::gGCellSize);
+    }
+
+    // The window of a bounded search doesn't cover the next connection, so only full-grid searches are resumed
+    const bool incremental = GlobalParam::gIncrementalSearch && !GlobalParam::gBoundedSearchWindow && route.mGridPins.size() > 2;
+    const SearchStatistics netStartStats = ws.getStatistics();
+    long long numReusedSettledCells = 0;
+
+    // Connect the current targets to the route with a new path
+    int numConnections = 0;
+    bool allConnected = true;
+    auto connectCurrentTargets = [this, &ws, &route, incremental, &netStartStats, &numReusedSettledCells, &numConnections, &allConnected]() {
         Location finalEnd{0, 0, 0};
         float routeCost = 0.0;
-
-        // GridPin.front() will be initilized inside
-        this->aStarSearching(route, finalEnd, routeCost);
+        bool found = false;
+
+        if (incremental && numConnections > 0) {
+            // Cells expanded so far, re-expansions counted once
+            numReusedSettledCells += (ws.getStatistics().numExpansions - netStartStats.numExpansions) -
+                                     (ws.getStatistics().numReExpansions - netStartStats.numReExpansions);
+            found = this->aStarSearchingIncrementally(ws, route, finalEnd, routeCost);
+            if (!found && ws.hasSearchCorridor()) {
+                // Search again from scratch without the corridor, the next connections resume from that search
+                ws.log() << "No path in the global routing corridor, retry without it" << std::endl;
+                ++ws.getStatistics().numCorridorRetries;
+                ws.clearSearchCorridor();
+                found = this->aStarSearching(ws, route, finalEnd, routeCost);
+            }
+        } else {
+            // GridPin.front() will be initilized inside
+            if (GlobalParam::gHierarchicalSearch && !incremental) {
+                // Resumed searches would miss the cells left out of the bands, so only the others go coarse-to-fine
+                found = this->aStarSearchingHierarchically(ws, route, finalEnd, routeCost);
+            } else {
+                found = this->aStarSearching(ws, route, finalEnd, routeCost);
+            }
+        }
+        allConnected = allConnected && found;
         route.currentRouteCost += routeCost;
+        ++numConnections;
 
         // TODO Fix this, when THROUGH PAD as a start?
-        this->backtrackingToGridPath(finalEnd, route);
+        if (GlobalParam::gBacktrackToSegments) {
+            this->backtrackingToGridPathSegments(ws, finalEnd, route);
+        } else {
+            this->backtrackingToGridPath(ws, finalEnd, route);
+        }
 
         // Reset temporary stuff
-        // For early break
-        this->clearTargetedPins(route.mGridPins.at(i).pinWithLayers);
-        // For 2D cost estimation
-        current_targeted_pin = Location{0, 0, 0};
-        // For 3D cost estimation
-        currentTargetedPinWithLayers.clear();
+        ws.clearCurrentTargets();
+    };
+
+    std::size_t steinerPointId = 0;
+    std::vector<Location> steinerPointTargets;
+    for (size_t i = 1; i < route.mGridPins.size(); ++i) {
+        // Steiner points the next pins branch from
+        for (; GlobalParam::gSteinerPointTargets && steinerPointId < route.mSteinerPoints.size() &&
+               route.mSteinerPoints.at(steinerPointId).nextGridPinId == static_cast<int>(i);
+             ++steinerPointId) {
+            this->getSteinerPointTargets(route, route.mSteinerPoints.at(steinerPointId).point, steinerPointTargets);
+            if (steinerPointTargets.empty()) {
+                continue;
+            }
+            ws.setCurrentTargets(steinerPointTargets);
+            connectCurrentTargets();
+            ++route.mNumSteinerGridPaths;
+        }
+
+        // For early break and the cost estimation
+        ws.setCurrentTargets(route.mGridPins.at(i).pinWithLayers);
+        connectCurrentTargets();
     }
+    ws.clearSearchCorridor();
 
-    // Put back GridPin's obstacle costs
+    if (incremental) {
+        ++ws.getStatistics().numIncrementalNets;
+        ws.getStatistics().numReusedSettledCells += numReusedSettledCells;
+        ws.log() << __FUNCTION__ << "(): net " << route.getNetId() << " searched incrementally, "
+                  << ws.getStatistics().numExpansions - netStartStats.numExpansions << " expansions, "
+                  << numReusedSettledCells << " settled cells reused" << std::endl;
+    }
+    return allConnected;
+}
+
+void BoardGrid::getSteinerPointTargets(const MultipinRoute &route, const Point_2D<int> &point, std::vector<Location> &targets) const {
+    targets.clear();
+    // Already on the route
+    for (const auto &gp : route.getGridPaths()) {
+        for (const auto &location : gp.getCells()) {
+            if (location.m_x == point.x() && location.m_y == point.y()) {
+                return;
+            }
+        }
+    }
+    // The free layers only, a blocked Steiner point would only drag the route into the obstacle
+    for (int z = 0; z < this->l; ++z) {
+        Location location{point.x(), point.y(), z};
+        if (this->validate_location(location) && this->base_cost_at(location) == 0) {
+            targets.push_back(location);
+        }
+    }
+}
+
+void BoardGrid::routeGridNetsFromScratch(std::vector<MultipinRoute *> &routes, const std::vector<GridBox> &windows, const int numThreads,
+                                         const bool removeGridPinObstacles) {
+    std::cout << __FUNCTION__ << "() routes.size: " << routes.size() << ", numThreads: " << numThreads << std::endl;
+
+    auto batchStart = std::chrono::steady_clock::now();
+
+    // Remove the GridPins' obstacle costs. A net's pins are inside its window, which the other nets' searches never read,
+    // so each search only sees the obstacle costs of its own pins removed, as in serial routing
     if (removeGridPinObstacles) {
-        this->addPinShapeObstacleCostToGrid(route.mGridPins, GlobalParam::gPinObstacleCost, true, false, true);
+        for (auto route : routes) {
+            if (route->mGridPins.size() > 1) {
+                this->addPinShapeObstacleCostToGrid(route->mGridPins, -GlobalParam::gPinObstacleCost, true, false, true);
+            }
+        }
+    }
+    // The grid is read-only until all the searches are done
+    this->updateCostIndices();
+
+    const int numWorkers = std::max(1, std::min(numThreads, static_cast<int>(routes.size())));
+    if (static_cast<int>(this->mWorkerWorkspaces.size()) < numWorkers) {
+        this->mWorkerWorkspaces.resize(numWorkers);
+    }
+    for (int i = 0; i < numWorkers; ++i) {
+        this->setupSearchWorkspace(this->mWorkerWorkspaces.at(i));
+    }
+
+    // Workers take the nets in order, a net's search only depends on the grid inside its window.
+    // The searches' logs are buffered per net and printed in the batch order
+    auto searchStart = std::chrono::steady_clock::now();
+    std::atomic<int> nextRouteId{0};
+    std::vector<std::string> searchLogs(routes.size());
+    std::vector<char> connected(routes.size(), 1);
+    auto worker = [this, &routes, &windows, &nextRouteId, &searchLogs, &connected](SearchWorkspace &ws) {
+        for (int i = nextRouteId++; i < static_cast<int>(routes.size()); i = nextRouteId++) {
+            if (routes.at(i)->mGridPins.size() > 1) {
+                std::ostringstream searchLog;
+                ws.setLog(&searchLog);
+                const GridBox &window = windows.at(i);
+                ws.setSearchWindowLimit(window.minX, window.minY, window.maxX, window.maxY);
+                connected.at(i) = this->searchGridNetFromScratch(ws, *routes.at(i));
+                ws.resetSearchWindowLimit();
+                ws.setLog(&std::cout);
+                searchLogs.at(i) = searchLog.str();
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int i = 1; i < numWorkers; ++i) {
+        threads.emplace_back(worker, std::ref(this->mWorkerWorkspaces.at(i)));
+    }
+    worker(this->mWorkerWorkspaces.front());
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    this->mParallelSearchTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - searchStart).count();
+    for (const auto &searchLog : searchLogs) {
+        std::cout << searchLog;
     }
 
-    // Convert from grid locations to grid paths
-    route.gridPathLocationsToSegments();
-    this->add_route_to_base_cost(route);
+    // Commit in the batch order, the nets not connected inside their windows are left out
+    for (std::size_t i = 0; i < routes.size(); ++i) {
+        if (routes.at(i)->mGridPins.size() > 1 && connected.at(i)) {
+            routes.at(i)->gridPathLocationsToSegments();
+            this->add_route_to_base_cost(*routes.at(i));
+        }
+    }
+
+    // Put back the GridPins' obstacle costs
+    if (removeGridPinObstacles) {
+        for (auto route : routes) {
+            if (route->mGridPins.size() > 1) {
+                this->addPinShapeObstacleCostToGrid(route->mGridPins, GlobalParam::gPinObstacleCost, true, false, true);
+            }
+        }
+    }
+
+    // Then they are routed one by one over the whole grid, against the committed batch
+    for (std::size_t i = 0; i < routes.size(); ++i) {
+        if (routes.at(i)->mGridPins.size() > 1 && !connected.at(i)) {
+            std::cout << __FUNCTION__ << "(): net " << routes.at(i)->getNetId() << " is not connected inside its window, route it serially" << std::endl;
+            routes.at(i)->clearGridPaths();
+            this->routeGridNetFromScratch(*routes.at(i), removeGridPinObstacles);
+            ++this->mNumParallelFallbacks;
+        }
+    }
+
+    for (int i = 0; i < numWorkers; ++i) {
+        this->mParallelWorkerSearchTime += this->mWorkerWorkspaces.at(i).getStatistics().searchTime;
+        this->mWorkspace.getStatistics() += this->mWorkerWorkspaces.at(i).getStatistics();
+        this->mWorkerWorkspaces.at(i).getStatistics() = SearchStatistics();
+    }
+    ++this->mNumParallelBatches;
+    this->mNumParallelNets += routes.size();
+    this->mMaxNumWorkers = std::max(this->mMaxNumWorkers, numWorkers);
+    this->mParallelRoutingTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - batchStart).count();
+}
+
+void BoardGrid::resetParallelRoutingStatistics() {
+    this->mNumParallelBatches = 0;
+    this->mNumParallelNets = 0;
+    this->mMaxNumWorkers = 0;
+    this->mParallelRoutingTime = 0.0;
+    this->mParallelSearchTime = 0.0;
+    this->mParallelWorkerSearchTime = 0.0;
+    this->mNumParallelFallbacks = 0;
 }
 
 void BoardGrid::ripup_route(MultipinRoute &route, const bool clearGridPaths) {
@@ -2351,6 +3538,13 @@ void BoardGrid::ripup_route(MultipinRoute &route, const bool clearGridPaths) {
     std::cout << "Finished ripup" << std::endl;
 }
 
+void BoardGrid::reprice_route(MultipinRoute &route, const double trackObstacleCost, const double viaObstacleCost) {
+    this->remove_route_from_base_cost(route);
+    route.setCurTrackObstacleCost(trackObstacleCost);
+    route.setCurViaObstacleCost(viaObstacleCost);
+    this->add_route_to_base_cost(route);
+}
+
 void BoardGrid::addGridNetclass(const GridNetclass &gridNetclass) {
     this->mGridNetclasses.push_back(gridNetclass);
 }
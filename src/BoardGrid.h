@@ -2,14 +2,21 @@
 #define PCBROUTER_BOARD_GRID_H
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <fstream>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <limits>
 #include <map>
+#include <queue>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include "BaseCostJournal.h"
 #include "GridCell.h"
 #include "GridDiffPairNet.h"
 #include "GridDiffPairNetclass.h"
@@ -19,6 +26,7 @@
 #include "IncrementalSearchGrids.h"
 #include "Location.h"
 #include "MultipinRoute.h"
+#include "SearchWorkspace.h"
 #include "globalParam.h"
 #include "point.h"
 
@@ -32,10 +40,7 @@ class BoardGrid {
     BoardGrid() {}
 
     //dtor
-    ~BoardGrid() {
-        delete[] this->grid;
-        this->grid = nullptr;
-    }
+    ~BoardGrid() {}
     void initilization(int w, int h, int l);
 
     // constraints
@@ -48,26 +53,48 @@ class BoardGrid {
     void routeGridNetFromScratch(MultipinRoute &route, const bool removeGridPinObstacles = false);
     void routeGridNetWithRoutedGridPaths(MultipinRoute &route, const bool removeGridPinObstacles = false, const bool routedPathsToGridCost = true);
     void routeGridDiffPairNet(GridDiffPairNet &route);
+    // Route a batch of nets on numThreads threads: each net searches the same grid inside its window,
+    // then the paths are added to the base cost in the batch order. The windows, grown by the nets'
+    // searching radii (trace/via size and clearance), must not intersect: then no search reads the cells
+    // another net of the batch changes, and the result doesn't depend on numThreads. A net that can't be
+    // connected inside its window is routed serially over the whole grid after the batch is committed
+    void routeGridNetsFromScratch(std::vector<MultipinRoute *> &routes, const std::vector<GridBox> &windows, const int numThreads,
+                                  const bool removeGridPinObstacles = false);
+    void resetParallelRoutingStatistics();
+    // Search the connections of a net, only the workspace and the route are written.
+    // Returns false if some connections are not found
+    bool searchGridNetFromScratch(SearchWorkspace &ws, MultipinRoute &route) const;
     void ripup_route(MultipinRoute &route, const bool clearGridPaths = true);
+    // Charge a route's paths at new obstacle costs: removed at its current ones, added back at the new ones
+    void reprice_route(MultipinRoute &route, const double trackObstacleCost, const double viaObstacleCost);
+    // Negotiated congestion, occupancy of the routed nets' footprints with present and history costs
+    void setPresentCongestionFactor(const float factor) { mPresentCongestionFactor = factor; }
+    float getPresentCongestionFactor() const { return mPresentCongestionFactor; }
+    void updateHistoryCongestionCost(const float increment);
+    int getOverflow(int &numCongestedCells) const;
+    bool isRouteCongested(const MultipinRoute &route) const;
+    // Flags the cells within margin (on the same layer) of the overflowed cells
+    void getCongestionNeighborhood(const int margin, std::vector<char> &cellFlags) const;
+    bool isRouteInFlaggedCells(const MultipinRoute &route, const std::vector<char> &cellFlags) const;
+    // Occupancy is tracked in negotiated congestion and selective rip-up modes
+    static bool isTrackingOccupancy() { return GlobalParam::gNegotiatedCongestion || GlobalParam::gSelectiveRipUp || GlobalParam::gStopOnZeroOverflow; }
+    void getRouteOccupiedGridCells(const MultipinRoute &route, std::vector<int> &cellIds) const;
+    // Transactions on the grid: rollbackTransaction() restores the base cost, cell types, occupancy,
+    // congestion costs and base cost journals changed since the matching beginTransaction(), transactions can be nested.
+    // The routes' grid paths belong to the caller and are not restored.
+    void beginTransaction();
+    void commitTransaction();
+    void rollbackTransaction();
+    bool isInTransaction() const { return !mTransactionMarkers.empty(); }
     // Obstacle cost
     void addPinShapeObstacleCostToGrid(const GridPin &gridPin, const float value, const bool toViaCost, const bool toViaForbidden, const bool toBaseCost);
     void addPinShapeObstacleCostToGrid(const std::vector<GridPin> &gridPins, const float value, const bool toViaCost, const bool toViaForbidden, const bool toBaseCost);
-    // working cost
-    void working_cost_fill(float value);
-    float working_cost_at(const Location &l) const;
-    void working_cost_set(float value, const Location &l);
-    // bending cost
-    void bending_cost_fill(float value);
-    float bending_cost_at(const Location &l) const;
-    void bending_cost_set(float value, const Location &l);
-    // cached trace cost
-    void cached_trace_cost_fill(float value);
-    float cached_trace_cost_at(const Location &l) const;
-    void cached_trace_cost_set(float value, const Location &l);
-    // cached via cost
-    void cached_via_cost_fill(float value);
-    float cached_via_cost_at(const Location &l) const;
-    void cached_via_cost_set(float value, const Location &l);
+    // Workspace used by the routing APIs above
+    SearchWorkspace &getSearchWorkspace() { return mWorkspace; }
+    // Sizes the workspace, and hooks up the persistent via cost caches if enabled
+    void setupSearchWorkspace(SearchWorkspace &ws) const;
+    // Bring the lazily updated cost indices up to date, so concurrent searches only read them
+    void updateCostIndices() const;
     // base cost
     void base_cost_fill(float value);
     float base_cost_at(const Location &l) const;
@@ -85,12 +112,6 @@ class BoardGrid {
     void via_cost_set(const float value, const Location &l);
     void via_cost_add(const float value, const Location &l);
     // void via_cost_fill(float value);
-    // targetPin
-    void setTargetedPins(const std::vector<Location> &pins);
-    void clearTargetedPins(const std::vector<Location> &pins);
-    void setTargetedPin(const Location &l);
-    void clearTargetedPin(const Location &l);
-    bool isTargetedPin(const Location &l);
     // via Forbidden
     void setViaForbiddenArea(const std::vector<Location> &locations);
     void clearViaForbiddenArea(const std::vector<Location> &locations);
@@ -113,79 +134,254 @@ class BoardGrid {
     // void print_features(std::vector<Location> features);
 
     void showViaCachePerformance() {
-        std::cout << "# Via Cost Cached Miss: " << this->viaCachedMissed << std::endl;
-        std::cout << "# Via Cost Cached Hit: " << this->viaCachedHit << std::endl;
-        std::cout << "# Via Cost Cached Hit ratio: " << (double)this->viaCachedHit / (this->viaCachedHit + this->viaCachedMissed) << std::endl;
+        const auto &stats = this->mWorkspace.getStatistics();
+        std::cout << "# Via Cost Cached Miss: " << stats.viaCachedMissed << std::endl;
+        std::cout << "# Via Cost Cached Hit: " << stats.viaCachedHit << std::endl;
+        std::cout << "# Via Cost Cached Hit ratio: " << (double)stats.viaCachedHit / (stats.viaCachedHit + stats.viaCachedMissed) << std::endl;
     }
+    void showSearchPerformance();
 
    private:
-    //Constraints
-    void setCurrentGridNetclassId(const int id) { currentGridNetclassId = id; }
-
     // Various costs
-    int getBendingCostOfNext(const Location &current, const Location &next) const;
+    int getBendingCostOfNext(const SearchWorkspace &ws, const Location &current, const Location &next) const;
     pr::prIntCost getLayerPrefCost(const MultipinRoute &route, const Location &pt) const;
+    // Congestion cost of a cell: history + present factor * occupancy
+    inline float congestion_cost_at(const Location &l) const {
+        const int id = l.m_x + l.m_y * this->w + l.m_z * this->w * this->h;
+        return this->mHistoryCongestionCost[id] + this->mPresentCongestionFactor * this->mNumTraces[id];
+    }
+    void addRouteOccupancy(const MultipinRoute &route, const int value);
 
     // trace_width
     float sized_trace_cost_at(const Location &l, const int traceRadius) const;
     float sized_trace_cost_at(const Location &l, const std::vector<Point_2D<int>> &traRelativeSearchGrids) const;
-    // came from id
-    void setCameFromId(const Location &l, const int id);
-    int getCameFromId(const Location &l) const;
-    int getCameFromId(const int id) const;
-    void clearAllCameFromId();
-
-    // A* estimated cost
-    float getAStarEstimatedCost(const Location &next);
-    float getAStarEstimatedCost(const Location &current, const Location &next);
+    // Trace/via costs of a netclass' searching space, by row prefix sums if enabled
+    float sized_trace_cost_at(const Location &l, const GridNetclass &gridNetclass) const;
+    void sizedViaCostBetweenStartEndLayer(const Location &l, const int startLayerId, const int endLayerId, const GridNetclass &gridNetclass, float &cost) const;
+    // Row prefix-sum cost engine
+    float sizedTraceCostBySpans(const Location &l, const std::vector<GridRowSpan> &spans) const;
+    float sizedViaCostBySpans(const Location &l, const int startLayerId, const int endLayerId, const std::vector<GridRowSpan> &spans) const;
+    void updateRowPrefixSums(const int rowId) const;
+    void setupRowPrefixSums() const;
+    // Every write to the base cost or the cell type goes through here
+    inline void markCostDirty(const int id) {
+        if (!this->mRowPrefixDirty.empty()) {
+            this->mRowPrefixDirty[id / this->w] = 1;
+        }
+        if (!this->mCostTileVersion.empty()) {
+            this->markCostTilesDirty(id);
+        }
+        if (!this->mCostPyramidDirty.empty()) {
+            this->markCostPyramidDirty(id);
+        }
+    }
+    void markAllCostDirty();
+    // Every base cost increment goes through here, recorded instead of applied while rasterizing a journal
+    inline void addBaseCostDelta(const int id, const float value) {
+        if (this->mBaseCostRecorder) {
+            this->mBaseCostRecorder->emplace_back(id, value);
+            return;
+        }
+        this->logBaseCostChange(id);
+        this->mBaseCost[id] += value;
+        this->markCostDirty(id);
+    }
+    void applyBaseCostJournal(const BaseCostJournal &journal, const bool negate);
+    // Undo log of the open transactions, the old value of a cell is logged before each write
+    inline void logBaseCostChange(const int id) {
+        if (!this->mTransactionMarkers.empty()) {
+            this->mBaseCostUndoLog.emplace_back(id, this->mBaseCost[id]);
+        }
+    }
+    inline void logCellTypeChange(const int id) {
+        if (!this->mTransactionMarkers.empty()) {
+            this->mCellTypeUndoLog.emplace_back(id, this->mCellType[id]);
+        }
+    }
+    inline void logNumTracesChange(const int id) {
+        if (!this->mTransactionMarkers.empty()) {
+            this->mNumTracesUndoLog.emplace_back(id, this->mNumTraces[id]);
+        }
+    }
+    inline void logHistoryCongestionChange(const int id) {
+        if (!this->mTransactionMarkers.empty()) {
+            this->mHistoryCongestionUndoLog.emplace_back(id, this->mHistoryCongestionCost[id]);
+        }
+    }
+    // Cost tiles of the persistent caches, a cell write invalidates the tiles within the searching radius
+    void setupCostTiles() const;
+    void markCostTilesDirty(const int id);
+    // Cost pyramid of the coarse-to-fine search, a cell write invalidates its level-1 block
+    void setupCostPyramid() const;
+    void updateCostPyramid() const;
+    void markCostPyramidDirty(const int id);
+    // Pooled base cost of a cell of a pyramid level (1 to gHierarchicalSearchLevel), per layer
+    inline float pooled_cost_at(const int level, const int x, const int y, const int z) const {
+        const int levelW = this->mCostPyramidW[level - 1];
+        return this->mCostPyramid[level - 1][x + y * levelW + z * levelW * this->mCostPyramidH[level - 1]];
+    }
+
+    // A* estimated cost, towards the workspace's current targets
+    float getAStarEstimatedCost(const SearchWorkspace &ws, const Location &next) const;
+    float getAStarEstimatedCost(const SearchWorkspace &ws, const Location &current, const Location &next) const;
     // Helpers for cost estimation
-    float get2dEstimatedCost(const Location &l);
-    float get2dEstimatedCostWithBendingCost(const Location &current, const Location &next);
-    float get2dMultiTargetEstimatedCost(const Location &l);
-    float get2dMultiTargetEstimatedCostWithBendingCost(const Location &current, const Location &next);
-    float get3dEstimatedCost(const Location &current);
-    float get3dEstimatedCostWithBendingCost(const Location &current, const Location &next);
+    float get2dEstimatedCost(const SearchWorkspace &ws, const Location &l) const;
+    float get2dEstimatedCostWithBendingCost(const SearchWorkspace &ws, const Location &current, const Location &next) const;
+    float get2dMultiTargetEstimatedCost(const SearchWorkspace &ws, const Location &l) const;
+    float get2dMultiTargetEstimatedCostWithBendingCost(const SearchWorkspace &ws, const Location &current, const Location &next) const;
+    float get3dEstimatedCost(const SearchWorkspace &ws, const Location &current) const;
+    float get3dEstimatedCostWithBendingCost(const SearchWorkspace &ws, const Location &current, const Location &next) const;
 
     void add_route_to_base_cost(const MultipinRoute &route);
     void add_route_to_base_cost(const MultipinRoute &route, const int traceRadius, const float traceCost, const int viaRadius, const float viaCost);
     void remove_route_from_base_cost(const MultipinRoute &route);
+    void addRouteGridPathsToBaseCost(const MultipinRoute &route, const bool negate);
     void addGridPathToBaseCost(const GridPath &route, const int gridNetclassId, const int traceRadius, const int diagonalTraceRadius, const float traceCost, const int viaRadius, const float viaCost);
     void getCostsVecByRadius(const float centerCost, const int radius, vector<float> &costVec);
 
     // void came_from_to_features(const std::unordered_map<Location, Location> &came_from, const Location &end, std::vector<Location> &features) const;
     // std::vector<Location> came_from_to_features(const std::unordered_map<Location, Location> &came_from, const Location &end) const;
     // void came_from_to_features(const Location &end, std::vector<Location> &features) const;
-    void backtrackingToGridPath(const Location &end, MultipinRoute &route) const;
+    void backtrackingToGridPath(const SearchWorkspace &ws, const Location &end, MultipinRoute &route) const;
+    // Same path as backtrackingToGridPath(), but only its corner points (and vias) are kept, directly as segments
+    void backtrackingToGridPathSegments(const SearchWorkspace &ws, const Location &end, MultipinRoute &route) const;
 
-    void getNeighbors(const Location &l, std::vector<std::pair<float, Location>> &ns);
+    // Planar neighbors are kept inside the workspace's search window
+    void getNeighbors(SearchWorkspace &ws, const Location &l, NeighborBuffer &ns) const;
 
     // std::unordered_map<Location, Location> dijkstras_with_came_from(const Location &start, int via_size);
     // std::unordered_map<Location, Location> dijkstras_with_came_from(const std::vector<Location> &route, int via_size);
     // void dijkstras_with_came_from(const std::vector<Location> &route, int via_size, std::unordered_map<Location, Location> &came_from);
     // void dijkstrasWithGridCameFrom(const std::vector<Location> &route, int via_size);
-    void aStarWithGridCameFrom(const std::vector<Location> &route, Location &finalEnd, float &finalCost);
-    void aStarSearching(MultipinRoute &route, Location &finalEnd, float &finalCost);
+    // Searches only read the grid, all the temporary state goes to the workspace
+    void aStarWithGridCameFrom(SearchWorkspace &ws, const std::vector<Location> &route, Location &finalEnd, float &finalCost) const;
+    // Returns false if none of the current targets is reached
+    bool aStarSearching(SearchWorkspace &ws, MultipinRoute &route, Location &finalEnd, float &finalCost) const;
+    // One search inside the workspace's search window
+    bool aStarSearchingInWindow(SearchWorkspace &ws, MultipinRoute &route, Location &finalEnd, float &finalCost) const;
+    template <typename Frontier>
+    bool aStarSearchingWithFrontier(SearchWorkspace &ws, MultipinRoute &route, Frontier &frontier, Location &finalEnd, float &finalCost) const;
+    // Pops the frontier until one of the current targets is reached
+    template <typename Frontier>
+    bool searchFrontierForTargets(SearchWorkspace &ws, MultipinRoute &route, Frontier &frontier, Location &finalEnd, float &finalCost) const;
+    // Incremental search of a net's next connection: resumes the previous connection's search,
+    // with the frontier re-keyed to the new targets and the last path added as sources
+    bool aStarSearchingIncrementally(SearchWorkspace &ws, MultipinRoute &route, Location &finalEnd, float &finalCost) const;
+    template <typename Frontier>
+    bool resumeSearchWithFrontier(SearchWorkspace &ws, MultipinRoute &route, Frontier &frontier, Location &finalEnd, float &finalCost) const;
+    // Relax the neighbors of a closed frontier entry
+    template <typename Frontier>
+    void expandFrontierEntry(SearchWorkspace &ws, const MultipinRoute &route, const Location &current, NeighborBuffer &neighbors, Frontier &frontier) const;
+    // Multi-terminal growth: one search tree for all the pins of a net, each reached pin's path is
+    // added to the sources at zero cost and the search goes on towards the remaining pins
+    // Returns false if some pins can't be reached
+    bool growSearchTree(SearchWorkspace &ws, MultipinRoute &route) const;
+    template <typename Frontier>
+    bool growSearchTreeWithFrontier(SearchWorkspace &ws, MultipinRoute &route, Frontier &frontier) const;
+    // Layers of a Steiner point to route to, none if the point is already on the route or blocked
+    void getSteinerPointTargets(const MultipinRoute &route, const Point_2D<int> &point, std::vector<Location> &targets) const;
+    // Coarse-to-fine search: the connection is solved on a level of the cost pyramid first,
+    // then searched at full resolution in a band around the coarse path (or without it if that fails)
+    bool aStarSearchingHierarchically(SearchWorkspace &ws, MultipinRoute &route, Location &finalEnd, float &finalCost) const;
+    // A* on the level's cells from the source tree to the current targets, the band is the
+    // coarse path dilated by margin cells (2D ids of the level). Returns false if no path.
+    bool getCoarsePathBand(SearchWorkspace &ws, const MultipinRoute &route, const int level, const int margin, std::vector<int> &band) const;
+    // Bounding box of the routed paths, the connected pins and the current targets
+    void getSearchBoundingBox(const SearchWorkspace &ws, const MultipinRoute &route, int &minX, int &minY, int &maxX, int &maxY) const;
 
     void convertDiffPairPathToTwoNetPaths(GridDiffPairNet &route);
 
-    void initializeFrontiers(const std::vector<Location> &route, LocationQueue<Location, float> &frontier);
-    void initializeFrontiers(const MultipinRoute &route, LocationQueue<Location, float> &frontier);
-    void initializeLocationToFrontier(const Location &start, LocationQueue<Location, float> &frontier);
+    template <typename Frontier>
+    void initializeFrontiers(SearchWorkspace &ws, const std::vector<Location> &route, Frontier &frontier) const;
+    template <typename Frontier>
+    void initializeFrontiers(SearchWorkspace &ws, const MultipinRoute &route, Frontier &frontier) const;
+    template <typename Frontier>
+    void initializeLocationToFrontier(SearchWorkspace &ws, const Location &start, Frontier &frontier) const;
+    template <typename Frontier>
+    void initializeGridPathToFrontier(SearchWorkspace &ws, const GridPath &gp, Frontier &frontier) const;
 
     int locationToId(const Location &l) const;
     void idToLocation(const int id, Location &l) const;
 
    private:
-    GridCell *grid = nullptr;  //Initialize to nullptr
-    int size = 0;              //Total number of cells
+    // Per-cell planes, indexed by locationToId()
+    std::vector<float> mBaseCost;  //Record Routed Nets's traces
+    std::vector<GridCellType> mCellType;
+    std::vector<int> mNumTraces;  // # nets occupying the cell
+    std::vector<float> mHistoryCongestionCost;
+    int size = 0;  //Total number of cells
+
+    // Row prefix sums of each (row, layer), (w + 1) entries per row, built on first use
+    // and lazily updated for the rows marked dirty by the cost writes
+    mutable std::vector<double> mBaseCostRowPrefix;
+    mutable std::vector<double> mViaCostRowPrefix;  // Via forbidden grids count as gViaForbiddenCost
+    mutable std::vector<char> mRowPrefixDirty;
+    mutable long long mNumRowPrefixUpdates = 0;
+
+    // Cost pyramid, level k sums the base cost of 2^k x 2^k cells of each layer (index k - 1), built on
+    // first use of the coarse-to-fine search and lazily updated from the level-1 blocks marked dirty
+    mutable std::vector<std::vector<float> > mCostPyramid;
+    mutable std::vector<int> mCostPyramidW;
+    mutable std::vector<int> mCostPyramidH;
+    mutable std::vector<char> mCostPyramidDirty;  // by level-1 block
+    mutable std::vector<int> mCostPyramidDirtyIds;
+    mutable long long mNumCostPyramidUpdates = 0;  // level-1 blocks updated
+
+    // Versions of the 2D cost tiles (gCostCacheTileSize), set up on the first use of a persistent cache
+    mutable std::vector<unsigned int> mCostTileVersion;
+    mutable int mCostTileSize = 0;
+    mutable int mNumCostTilesX = 0;
+    mutable int mNumCostTilesY = 0;
+    mutable int mCostTileRadius = 0;  // the largest searching radius of the netclasses
+    mutable int mNumCostTileNetclasses = 0;
+
+    float mPresentCongestionFactor = 0.0;
+
+    // Base cost journals of the routes on the grid, by net id (stacked if a net is added more than once)
+    std::map<int, std::vector<BaseCostJournal> > mBaseCostJournals;
+    std::vector<std::pair<int, float> > *mBaseCostRecorder = nullptr;
+    // Transactions, each marker holds the undo log sizes at its beginTransaction()
+    struct TransactionMarker {
+        std::size_t numBaseCostChanges;
+        std::size_t numCellTypeChanges;
+        std::size_t numNumTracesChanges;
+        std::size_t numHistoryCongestionChanges;
+        std::size_t numJournalChanges;
+        float presentCongestionFactor;  // restored as a whole
+    };
+    struct JournalUndoEntry {
+        int netId;
+        bool pushed;              // pushed by add_route_to_base_cost(), otherwise popped by a rip-up
+        BaseCostJournal journal;  // the popped journal
+    };
+    std::vector<TransactionMarker> mTransactionMarkers;
+    std::vector<std::pair<int, float> > mBaseCostUndoLog;
+    std::vector<std::pair<int, GridCellType> > mCellTypeUndoLog;
+    std::vector<std::pair<int, int> > mNumTracesUndoLog;
+    std::vector<std::pair<int, float> > mHistoryCongestionUndoLog;
+    std::vector<JournalUndoEntry> mJournalUndoLog;
+
+    // Rip-up statistics
+    long long mNumJournalRipups = 0;
+    long long mNumRasterRipups = 0;
+    double mJournalRipupTime = 0.0;
+    double mRasterRipupTime = 0.0;
+    long long mNumJournals = 0;
+    long long mJournalBytes = 0;  // summed over the recorded journals
 
-    long long viaCachedMissed = 0;
-    long long viaCachedHit = 0;
+    // Search state of the routing APIs
+    SearchWorkspace mWorkspace;
+    // Per-thread search state of routeGridNetsFromScratch()
+    std::vector<SearchWorkspace> mWorkerWorkspaces;
 
-    int currentGridNetclassId;
-    Location current_targeted_pin;
-    //TODO:: Experiment on this...
-    std::vector<Location> currentTargetedPinWithLayers;
+    // Parallel routing statistics
+    long long mNumParallelBatches = 0;
+    long long mNumParallelNets = 0;
+    int mMaxNumWorkers = 0;
+    double mParallelRoutingTime = 0.0;       // wall time of routeGridNetsFromScratch()
+    double mParallelSearchTime = 0.0;        // wall time of the batches' searches
+    double mParallelWorkerSearchTime = 0.0;  // search time summed over the workers
+    long long mNumParallelFallbacks = 0;     // nets routed serially after their batch
 
     // Netclass mapping from DB netclasses, indices are aligned
     std::vector<GridNetclass> mGridNetclasses;
@@ -0,0 +1,64 @@
+#ifndef PCBROUTER_COST_TILE_CACHE_H
+#define PCBROUTER_COST_TILE_CACHE_H
+
+#include <vector>
+
+// Cached costs of a w x h x l grid that persist across routes. The board is
+// divided into square 2D tiles, BoardGrid bumps a tile's version whenever a cost
+// around it changes, and a tile whose version differs from the board's one is
+// cleared (back to -1, i.e. unknown) on all layers on its next access.
+class CostTileCache {
+   public:
+    void setup(const int w, const int h, const int l, const int tileSize, const int numTilesX, const int numTilesY) {
+        if (mW == w && mH == h && mL == l && mTileSize == tileSize) {
+            return;
+        }
+        mW = w;
+        mH = h;
+        mL = l;
+        mTileSize = tileSize;
+        mNumTilesX = numTilesX;
+        mCost.assign(w * h * l, -1.0);
+        mTileVersion.assign(numTilesX * numTilesY, 0);
+        mNumTileRefreshes = 0;
+    }
+
+    // Cached value at (x, y, z), -1 if unknown
+    inline float at(const int x, const int y, const int z, const std::vector<unsigned int> &boardTileVersion) {
+        const int tileId = x / mTileSize + (y / mTileSize) * mNumTilesX;
+        if (mTileVersion[tileId] != boardTileVersion[tileId]) {
+            this->clearTile(tileId, boardTileVersion[tileId]);
+        }
+        return mCost[x + y * mW + z * mW * mH];
+    }
+    // Only valid right after at() of the same cell, which brings its tile up to date
+    inline void set(const int x, const int y, const int z, const float value) { mCost[x + y * mW + z * mW * mH] = value; }
+
+    long long getNumTileRefreshes() const { return mNumTileRefreshes; }
+
+   private:
+    void clearTile(const int tileId, const unsigned int version) {
+        const int tileX = (tileId % mNumTilesX) * mTileSize;
+        const int tileY = (tileId / mNumTilesX) * mTileSize;
+        for (int z = 0; z < mL; ++z) {
+            for (int y = tileY; y < tileY + mTileSize && y < mH; ++y) {
+                for (int x = tileX; x < tileX + mTileSize && x < mW; ++x) {
+                    mCost[x + y * mW + z * mW * mH] = -1.0;
+                }
+            }
+        }
+        mTileVersion[tileId] = version;
+        ++mNumTileRefreshes;
+    }
+
+    int mW = 0;
+    int mH = 0;
+    int mL = 0;
+    int mTileSize = 0;
+    int mNumTilesX = 0;
+    std::vector<float> mCost;
+    std::vector<unsigned int> mTileVersion;
+    long long mNumTileRefreshes = 0;
+};
+
+#endif
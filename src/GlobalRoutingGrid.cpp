@@ -0,0 +1,153 @@
+#include "GlobalRoutingGrid.h"
+
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+
+void GlobalRoutingGrid::setup(const BoardGrid &bg, const int gcellSize) {
+    this->mGCellSize = std::max(gcellSize, 1);
+    this->mNumGCellsX = (bg.w + this->mGCellSize - 1) / this->mGCellSize;
+    this->mNumGCellsY = (bg.h + this->mGCellSize - 1) / this->mGCellSize;
+
+    // Free cells of a GCell over all the layers, a track takes gcellSize of them
+    std::vector<int> numFreeCells(this->getNumGCells(), 0);
+    for (int z = 0; z < bg.l; ++z) {
+        for (int y = 0; y < bg.h; ++y) {
+            for (int x = 0; x < bg.w; ++x) {
+                if (bg.base_cost_at(Location{x, y, z}) == 0) {
+                    ++numFreeCells[this->getGCellId(x, y)];
+                }
+            }
+        }
+    }
+    this->mCapacity.resize(this->getNumGCells());
+    for (int i = 0; i < this->getNumGCells(); ++i) {
+        this->mCapacity[i] = (float)numFreeCells[i] / this->mGCellSize;
+    }
+    this->mDemand.assign(this->getNumGCells(), 0.0);
+}
+
+float GlobalRoutingGrid::getGCellCost(const int gcellId) const {
+    const float capacity = this->mCapacity[gcellId];
+    const float demand = this->mDemand[gcellId];
+    if (demand + 1.0 > capacity) {
+        return 1.0 + GlobalParam::gGCellOverflowCost * (demand + 1.0 - capacity);
+    }
+    return 1.0 + demand / capacity;
+}
+
+void GlobalRoutingGrid::routeToTree(const int targetId, std::vector<char> &isInTree, std::vector<int> &tree) {
+    if (isInTree[targetId]) {
+        return;
+    }
+
+    const int targetX = targetId % this->mNumGCellsX;
+    const int targetY = targetId / this->mNumGCellsX;
+    // Every step costs at least 1
+    auto estimatedCost = [this, targetX, targetY](const int id) {
+        return (float)(abs(id % this->mNumGCellsX - targetX) + abs(id / this->mNumGCellsX - targetY));
+    };
+
+    std::vector<float> cost(this->getNumGCells(), std::numeric_limits<float>::infinity());
+    std::vector<int> cameFrom(this->getNumGCells(), -1);
+    std::priority_queue<std::pair<float, int>, std::vector<std::pair<float, int>>, std::greater<std::pair<float, int>>> frontier;
+    for (const auto id : tree) {
+        cost[id] = 0.0;
+        frontier.emplace(estimatedCost(id), id);
+    }
+
+    while (!frontier.empty()) {
+        const float key = frontier.top().first;
+        const int id = frontier.top().second;
+        frontier.pop();
+        if (id == targetId) {
+            break;
+        }
+        if (key > cost[id] + estimatedCost(id)) {
+            continue;
+        }
+
+        const int x = id % this->mNumGCellsX;
+        const int y = id / this->mNumGCellsX;
+        const int neighborIds[4] = {x > 0 ? id - 1 : -1, x + 1 < this->mNumGCellsX ? id + 1 : -1,
+                                    y > 0 ? id - this->mNumGCellsX : -1, y + 1 < this->mNumGCellsY ? id + this->mNumGCellsX : -1};
+        for (const int neighborId : neighborIds) {
+            if (neighborId < 0) continue;
+            float newCost = cost[id] + this->getGCellCost(neighborId);
+            if (newCost < cost[neighborId]) {
+                cost[neighborId] = newCost;
+                cameFrom[neighborId] = id;
+                frontier.emplace(newCost + estimatedCost(neighborId), neighborId);
+            }
+        }
+    }
+
+    for (int id = targetId; id != -1 && !isInTree[id]; id = cameFrom[id]) {
+        isInTree[id] = 1;
+        tree.push_back(id);
+    }
+}
+
+void GlobalRoutingGrid::routeNet(const MultipinRoute &route, const int margin, std::vector<int> &corridor) {
+    corridor.clear();
+    const auto &gridPins = route.getGridPins();
+    if (gridPins.empty()) {
+        return;
+    }
+
+    // Pins in the routing order, each one to the tree of the previous ones
+    std::vector<char> isInTree(this->getNumGCells(), 0);
+    std::vector<int> tree;
+    const int firstId = this->getGCellId(gridPins.front().getPinCenter().x(), gridPins.front().getPinCenter().y());
+    isInTree[firstId] = 1;
+    tree.push_back(firstId);
+    for (std::size_t i = 1; i < gridPins.size(); ++i) {
+        this->routeToTree(this->getGCellId(gridPins.at(i).getPinCenter().x(), gridPins.at(i).getPinCenter().y()), isInTree, tree);
+    }
+    for (const auto id : tree) {
+        this->mDemand[id] += 1.0;
+    }
+
+    std::vector<char> isInCorridor(this->getNumGCells(), 0);
+    auto addDilatedGCell = [this, margin, &isInCorridor, &corridor](const int id) {
+        const int x = id % this->mNumGCellsX;
+        const int y = id / this->mNumGCellsX;
+        for (int gy = std::max(y - margin, 0); gy <= std::min(y + margin, this->mNumGCellsY - 1); ++gy) {
+            for (int gx = std::max(x - margin, 0); gx <= std::min(x + margin, this->mNumGCellsX - 1); ++gx) {
+                const int gcellId = gy * this->mNumGCellsX + gx;
+                if (!isInCorridor[gcellId]) {
+                    isInCorridor[gcellId] = 1;
+                    corridor.push_back(gcellId);
+                }
+            }
+        }
+    };
+    for (const auto id : tree) {
+        addDilatedGCell(id);
+    }
+    for (const auto &gridPin : gridPins) {
+        for (const auto &location : gridPin.getPinWithLayers()) {
+            addDilatedGCell(this->getGCellId(location.x(), location.y()));
+        }
+    }
+}
+
+int GlobalRoutingGrid::getNumOverflowGCells() const {
+    int numOverflowGCells = 0;
+    for (int i = 0; i < this->getNumGCells(); ++i) {
+        if (this->mDemand[i] > this->mCapacity[i]) {
+            ++numOverflowGCells;
+        }
+    }
+    return numOverflowGCells;
+}
+
+double GlobalRoutingGrid::getTotalOverflow() const {
+    double totalOverflow = 0.0;
+    for (int i = 0; i < this->getNumGCells(); ++i) {
+        totalOverflow += std::max(this->mDemand[i] - this->mCapacity[i], 0.0f);
+    }
+    return totalOverflow;
+}
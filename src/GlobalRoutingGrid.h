@@ -0,0 +1,51 @@
+#ifndef PCBROUTER_GLOBAL_ROUTING_GRID_H
+#define PCBROUTER_GLOBAL_ROUTING_GRID_H
+
+#include <algorithm>
+#include <vector>
+
+#include "BoardGrid.h"
+#include "MultipinRoute.h"
+#include "globalParam.h"
+
+// Coarse routing grid of GCells (gcellSize x gcellSize cells of the board grid). The capacity
+// of a GCell is the number of tracks its free cells (zero base cost) can hold over all the
+// layers, and every net crossing it takes one. Nets are routed as trees of GCells, with a
+// cost growing with the congestion, to give each net a corridor for the detailed search.
+class GlobalRoutingGrid {
+   public:
+    //ctor
+    GlobalRoutingGrid() {}
+    //dtor
+    ~GlobalRoutingGrid() {}
+
+    // Estimate the capacities from the current base cost of the board
+    void setup(const BoardGrid &bg, const int gcellSize);
+
+    // Route the pins of a net on the GCells and take the capacity of its tree,
+    // the corridor is the tree (and the pins' GCells) dilated by margin GCells
+    void routeNet(const MultipinRoute &route, const int margin, std::vector<int> &corridor);
+
+    int getGCellSize() const { return mGCellSize; }
+    int getNumGCellsX() const { return mNumGCellsX; }
+    int getNumGCellsY() const { return mNumGCellsY; }
+    int getNumGCells() const { return mNumGCellsX * mNumGCellsY; }
+    // GCells whose demand exceeds the capacity, and the total excess
+    int getNumOverflowGCells() const;
+    double getTotalOverflow() const;
+
+   private:
+    int getGCellId(const int x, const int y) const { return std::min(y / mGCellSize, mNumGCellsY - 1) * mNumGCellsX + std::min(x / mGCellSize, mNumGCellsX - 1); }
+    // Cost of adding one more net to a GCell
+    float getGCellCost(const int gcellId) const;
+    // A* from the tree GCells to the target GCell, the GCells of the path are added to the tree
+    void routeToTree(const int targetId, std::vector<char> &isInTree, std::vector<int> &tree);
+
+    int mGCellSize = 0;
+    int mNumGCellsX = 0;
+    int mNumGCellsY = 0;
+    std::vector<float> mCapacity;
+    std::vector<float> mDemand;
+};
+
+#endif
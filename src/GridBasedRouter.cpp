@@ -1054,6 +1054,10 @@ void GridBasedRouter::route_diff_pairs() {
     std::string initialMapNameTag = util::getFileNameWoExtension(mDb.getFileName()) + ".initial" + this->getParamsNameTag();
     mBg.printMatPlot(initialMapNameTag);
 
+    if (GlobalParam::gGlobalRouting) {
+        this->setupGlobalRoutingCorridors();
+    }
+
     // Add all nets to grid routes
     double totalCurrentRouteCost = 0.0;
     bestTotalRouteCost = 0.0;
@@ -1092,8 +1096,8 @@ void GridBasedRouter::route_diff_pairs() {
     std::vector<double> iterativeCost;
     iterativeCost.push_back(totalCurrentRouteCost);
     bestTotalRouteCost = totalCurrentRouteCost;
+    this->bestSolutionVersion = routingSolutions.commit(this->mGridNets);
     this->bestSolution = this->mGridNets;
-    routingSolutions.push_back(this->mGridNets);
 
     std::cout << "i=0, totalCurrentRouteCost: " << totalCurrentRouteCost << ", bestTotalRouteCost: " << bestTotalRouteCost << std::endl;
 
@@ -1121,6 +1125,14 @@ void GridBasedRouter::route_all() {
     std::string initialMapNameTag = util::getFileNameWoExtension(mDb.getFileName()) + ".initial" + this->getParamsNameTag();
     mBg.printMatPlot(initialMapNameTag);
 
+    if (GlobalParam::gGlobalRouting) {
+        this->setupGlobalRoutingCorridors();
+    }
+
+    if (GlobalParam::gNegotiatedCongestion) {
+        mBg.setPresentCongestionFactor(GlobalParam::gPresentCongestionCost);
+    }
+
     // Route all nets!
     this->routeSingleIteration();
 
@@ -1128,9 +1140,9 @@ void GridBasedRouter::route_all() {
     std::vector<double> iterativeCost;
     double totalCurrentRouteCost = this->getOverallRouteCost(this->mGridNets);
     iterativeCost.push_back(totalCurrentRouteCost);
-    routingSolutions.push_back(this->mGridNets);
+    this->bestSolutionVersion = routingSolutions.commit(this->mGridNets);
+    const int firstVersion = this->bestSolutionVersion;
     this->bestTotalRouteCost = totalCurrentRouteCost;
-    this->bestSolution = this->mGridNets;
 
     if (GlobalParam::gOutputDebuggingKiCadFile) {
         std::string nameTag = "fristTimeRouteAll";
@@ -1142,11 +1154,55 @@ void GridBasedRouter::route_all() {
         mBg.printMatPlot(mapNameTag);
     }
 
-    std::cout << "\n\n======= Start Fixed-Order Rip-Up and Re-Route all nets. =======\n\n";
+    if (GlobalParam::gNegotiatedCongestion) {
+        std::cout << "\n\n======= Start Negotiated-Congestion Rip-Up and Re-Route. =======\n\n";
+    } else if (GlobalParam::gSelectiveRipUp) {
+        std::cout << "\n\n======= Start Selective Rip-Up and Re-Route of the conflicting nets. =======\n\n";
+    } else {
+        std::cout << "\n\n======= Start Fixed-Order Rip-Up and Re-Route all nets. =======\n\n";
+    }
 
+    // Negotiated congestion iterations are not rolled back, a rolled back one would only be repeated:
+    // its history costs are part of the transaction
+    const bool speculative = GlobalParam::gSpeculativeRipUpReRoute && !GlobalParam::gNegotiatedCongestion;
+    int numRolledBackIterations = 0;
+
+    auto ripUpReRouteStart = std::chrono::steady_clock::now();
+    int numStalledIterations = 0;
+    int numIterations = 0;
+    std::string stopReason = "reached the maximum #iterations";
     for (int i = 0; i < static_cast<int>(GlobalParam::gNumRipUpReRouteIteration); ++i) {
-        // Route all nets!
-        this->routeSingleIteration(true);
+        if (this->isOverflowFree(stopReason)) {
+            break;
+        }
+        if (speculative) {
+            mBg.beginTransaction();
+            this->mSaveRoutesBeforeRipUp = true;
+        }
+        bool rerouted = true;
+        if (GlobalParam::gNegotiatedCongestion) {
+            // Reroute the congested nets only
+            if (!this->routeCongestedNets(i + 1)) {
+                stopReason = "no overlap remains";
+                rerouted = false;
+            }
+        } else if (GlobalParam::gSelectiveRipUp) {
+            // Reroute the nets in conflicts and their neighbors only
+            if (!this->routeConflictingNets(i + 1)) {
+                stopReason = "no net is in conflict";
+                rerouted = false;
+            }
+        } else {
+            // Route all nets!
+            this->routeSingleIteration(true);
+        }
+        if (!rerouted) {
+            if (speculative) {
+                mBg.commitTransaction();
+                this->clearRoutesSavedBeforeRipUp();
+            }
+            break;
+        }
 
         // Debugging output files
         if (GlobalParam::gOutputDebuggingKiCadFile) {
@@ -1161,20 +1217,49 @@ void GridBasedRouter::route_all() {
 
         // See if is a better routing solution
         totalCurrentRouteCost = this->getOverallRouteCost(this->mGridNets);
+        if (speculative) {
+            if (totalCurrentRouteCost > iterativeCost.back() + GlobalParam::gEpsilon) {
+                std::cout << "Speculative iteration " << i + 1 << ": cost " << totalCurrentRouteCost << " is worse than " << iterativeCost.back()
+                          << ", roll back" << std::endl;
+                mBg.rollbackTransaction();
+                this->restoreRoutesOfRejectedIteration();
+                totalCurrentRouteCost = this->getOverallRouteCost(this->mGridNets);
+                ++numRolledBackIterations;
+            } else {
+                mBg.commitTransaction();
+            }
+            this->clearRoutesSavedBeforeRipUp();
+        }
+        int version = routingSolutions.commit(this->mGridNets);
+        double prevBestTotalRouteCost = bestTotalRouteCost;
         if (totalCurrentRouteCost < bestTotalRouteCost) {
             bestTotalRouteCost = totalCurrentRouteCost;
-            this->bestSolution = this->mGridNets;
+            this->bestSolutionVersion = version;
         }
-        routingSolutions.push_back(this->mGridNets);
         iterativeCost.push_back(totalCurrentRouteCost);
+        ++numIterations;
+
+        if (this->isRipUpReRouteConverged(prevBestTotalRouteCost, totalCurrentRouteCost, numIterations, ripUpReRouteStart, numStalledIterations, stopReason)) {
+            break;
+        }
+    }
+    std::cout << "Rip-up and re-route stopped after " << numIterations << " iterations: " << stopReason << std::endl;
+    if (speculative) {
+        std::cout << "Speculative rip-up and re-route: " << numRolledBackIterations << " of " << numIterations << " iterations rolled back" << std::endl;
+    }
+
+    if (BoardGrid::isTrackingOccupancy()) {
+        int numCongestedCells = 0;
+        int overflow = mBg.getOverflow(numCongestedCells);
+        std::cout << "Final overflow: " << overflow << ", #congested grids: " << numCongestedCells << std::endl;
     }
 
     std::cout << "\n\n======= Rip-up and Re-route cost breakdown =======" << std::endl;
     for (std::size_t i = 0; i < iterativeCost.size(); ++i) {
         cout << "i=" << i << ", cost: " << iterativeCost.at(i)
-             << ", WL: " << this->get_routed_wirelength(routingSolutions.at(i))
-             << ", #Vias: " << this->get_routed_num_vias(routingSolutions.at(i))
-             << ", #Bends: " << this->get_routed_num_bends(routingSolutions.at(i));
+             << ", WL: " << routingSolutions.getRoutedWirelength(firstVersion + i)
+             << ", #Vias: " << routingSolutions.getRoutedNumVias(firstVersion + i)
+             << ", #Bends: " << routingSolutions.getRoutedNumBends(firstVersion + i);
 
         if (fabs(bestTotalRouteCost - iterativeCost.at(i)) < GlobalParam::gEpsilon) {
             cout << " <- best result" << std::endl;
@@ -1182,6 +1267,9 @@ void GridBasedRouter::route_all() {
             cout << std::endl;
         }
     }
+    std::cout << "Solution history: " << routingSolutions.getNumVersions() << " versions, #stored nets: " << routingSolutions.getNumStoredRoutes()
+              << ", #shared nets: " << routingSolutions.getNumSharedRoutes() << std::endl;
+    routingSolutions.restore(this->bestSolutionVersion, this->bestSolution);
 
     // Output final result to KiCad file
     std::string nameTag = "bestSolutionWithMerging";
@@ -1207,6 +1295,38 @@ void GridBasedRouter::route_all() {
     // Output final result to KiCad file
     nameTag = "afterPostProcessing." + this->getParamsNameTag();
     writeSolutionBackToDbAndSaveOutput(nameTag, this->bestSolution);
+
+    mBg.showSearchPerformance();
+}
+
+void GridBasedRouter::saveRouteBeforeRipUp(MultipinRoute &route, const bool onGrid) {
+    if (!this->mSaveRoutesBeforeRipUp || !this->mRipUpRoutes.insert(&route).second) {
+        return;
+    }
+    // A differential pair is saved as its MultipinRoute part, it refers to its nets in mGridNets
+    this->mRoutesBeforeRipUp.push_back(SavedRoute{&route, route, onGrid});
+}
+
+void GridBasedRouter::restoreRoutesOfRejectedIteration() {
+    for (auto &savedRoute : this->mRoutesBeforeRipUp) {
+        MultipinRoute &route = *savedRoute.route;
+        const double trackObstacleCost = route.getCurTrackObstacleCost();
+        const double viaObstacleCost = route.getCurViaObstacleCost();
+        // The rolled back grid has the saved paths charged at the saved obstacle costs
+        route = savedRoute.savedRoute;
+        if (savedRoute.onGrid) {
+            mBg.reprice_route(route, trackObstacleCost, viaObstacleCost);
+        } else {
+            route.setCurTrackObstacleCost(trackObstacleCost);
+            route.setCurViaObstacleCost(viaObstacleCost);
+        }
+    }
+}
+
+void GridBasedRouter::clearRoutesSavedBeforeRipUp() {
+    this->mSaveRoutesBeforeRipUp = false;
+    this->mRoutesBeforeRipUp.clear();
+    this->mRipUpRoutes.clear();
 }
 
 float GridBasedRouter::getOverallRouteCost(const std::vector<MultipinRoute> &gridNets) {
@@ -1217,17 +1337,49 @@ float GridBasedRouter::getOverallRouteCost(const std::vector<MultipinRoute> &gri
     return overallRouteCost;
 }
 
-void GridBasedRouter::routeSingleIteration(const bool ripupRoutedNet) {
-    routeDiffPairs(ripupRoutedNet);
-    routeSignalNets(ripupRoutedNet);
+void GridBasedRouter::setupGlobalRoutingCorridors() {
+    auto globalRoutingStart = std::chrono::steady_clock::now();
+    // Capacities from the base cost with all the pins as obstacles
+    GlobalRoutingGrid globalRoutingGrid;
+    globalRoutingGrid.setup(mBg, GlobalParam::gGCellSize);
+
+    int numRoutedNets = 0;
+    long long numCorridorGCells = 0;
+    std::vector<int> corridor;
+    for (auto &gridRoute : this->mGridNets) {
+        if (gridRoute.getGridPins().size() < 2) {
+            continue;
+        }
+        globalRoutingGrid.routeNet(gridRoute, GlobalParam::gCorridorMargin, corridor);
+        gridRoute.setSearchCorridor(corridor);
+        ++numRoutedNets;
+        numCorridorGCells += corridor.size();
+    }
+
+    std::cout << "Global routing: " << numRoutedNets << " nets on " << globalRoutingGrid.getNumGCellsX() << "x" << globalRoutingGrid.getNumGCellsY()
+              << " GCells of " << globalRoutingGrid.getGCellSize() << " grids, overflowed GCells: " << globalRoutingGrid.getNumOverflowGCells()
+              << ", total overflow: " << globalRoutingGrid.getTotalOverflow() << std::endl;
+    if (numRoutedNets > 0) {
+        std::cout << "Global routing: avg. corridor " << (double)numCorridorGCells / numRoutedNets << " GCells ("
+                  << 100.0 * numCorridorGCells / numRoutedNets / globalRoutingGrid.getNumGCells() << "% of the board), time: "
+                  << std::chrono::duration<double>(std::chrono::steady_clock::now() - globalRoutingStart).count() << " s" << std::endl;
+    }
 }
 
-void GridBasedRouter::routeDiffPairs(const bool ripupRoutedNet) {
+void GridBasedRouter::routeSingleIteration(const bool ripupRoutedNet, const std::vector<bool> &rerouteNetIds) {
+    routeDiffPairs(ripupRoutedNet, rerouteNetIds);
+    routeSignalNets(ripupRoutedNet, rerouteNetIds);
+}
+
+void GridBasedRouter::routeDiffPairs(const bool ripupRoutedNet, const std::vector<bool> &rerouteNetIds) {
     auto &nets = mDb.getNets();
 
     for (auto &gridDPNet : this->mGridDiffPairNets) {
         MultipinRoute &gn1 = gridDPNet.getGridNet1();
         MultipinRoute &gn2 = gridDPNet.getGridNet2();
+        if (!rerouteNetIds.empty() && !rerouteNetIds.at(gn1.getNetId()) && !rerouteNetIds.at(gn2.getNetId())) {
+            continue;
+        }
 
         std::cout << "\n\nRouting differential pair nets: " << nets.at(gn1.getNetId()).getName()
                   << "(" << gn1.getNetId() << ") and " << nets.at(gn2.getNetId()).getName()
@@ -1244,6 +1396,9 @@ void GridBasedRouter::routeDiffPairs(const bool ripupRoutedNet) {
             gn2.setCurViaObstacleCost(GlobalParam::gViaInsertionCost);
         } else {
             // Rip-up routed net
+            this->saveRouteBeforeRipUp(gridDPNet, false);
+            this->saveRouteBeforeRipUp(gn1);
+            this->saveRouteBeforeRipUp(gn2);
             gridDPNet.clearGridPaths();
             mBg.ripup_route(gn1);
             mBg.ripup_route(gn2);
@@ -1262,7 +1417,125 @@ void GridBasedRouter::routeDiffPairs(const bool ripupRoutedNet) {
     }
 }
 
-void GridBasedRouter::routeSignalNets(const bool ripupRoutedNet) {
+bool GridBasedRouter::routeCongestedNets(const int iteration) {
+    int numCongestedCells = 0;
+    int overflow = mBg.getOverflow(numCongestedCells);
+    if (overflow == 0) {
+        std::cout << "Negotiated congestion iteration " << iteration << ": no overlap remains, stop rip-up and re-route." << std::endl;
+        return false;
+    }
+
+    std::vector<bool> rerouteNetIds;
+    int numReroutedNets = this->getConflictingNets(0, rerouteNetIds);
+
+    // Overflowed grids become more expensive for the following iterations
+    mBg.updateHistoryCongestionCost(GlobalParam::gHistoryCongestionCost);
+    mBg.setPresentCongestionFactor(mBg.getPresentCongestionFactor() * GlobalParam::gPresentCongestionGrowth);
+
+    long long numSearches = mBg.getSearchWorkspace().getStatistics().numSearches;
+    this->routeSingleIteration(true, rerouteNetIds);
+    numSearches = mBg.getSearchWorkspace().getStatistics().numSearches - numSearches;
+
+    std::cout << "Negotiated congestion iteration " << iteration << ": #rerouted nets: " << numReroutedNets
+              << ", overflow before: " << overflow << ", #congested grids before: " << numCongestedCells
+              << ", present factor: " << mBg.getPresentCongestionFactor()
+              << ", #A* searches: " << numSearches << std::endl;
+    return true;
+}
+
+bool GridBasedRouter::routeConflictingNets(const int iteration) {
+    int numCongestedCells = 0;
+    int overflow = mBg.getOverflow(numCongestedCells);
+    std::vector<bool> rerouteNetIds;
+    int numReroutedNets = this->getConflictingNets(GlobalParam::gConflictNeighborMargin, rerouteNetIds);
+    if (numReroutedNets == 0) {
+        std::cout << "Selective rip-up iteration " << iteration << ": no net is in conflict, stop rip-up and re-route." << std::endl;
+        return false;
+    }
+
+    long long numSearches = mBg.getSearchWorkspace().getStatistics().numSearches;
+    this->routeSingleIteration(true, rerouteNetIds);
+    numSearches = mBg.getSearchWorkspace().getStatistics().numSearches - numSearches;
+
+    std::cout << "Selective rip-up iteration " << iteration << ": #rerouted nets: " << numReroutedNets
+              << " out of " << this->mGridNets.size() << ", overflow before: " << overflow
+              << ", #congested grids before: " << numCongestedCells << ", #A* searches: " << numSearches << std::endl;
+    return true;
+}
+
+int GridBasedRouter::getConflictingNets(const int neighborMargin, std::vector<bool> &rerouteNetIds) {
+    // mGridNets is indexed by net id
+    rerouteNetIds.assign(this->mGridNets.size(), false);
+    int numConflictingNets = 0;
+    for (std::size_t netId = 0; netId < this->mGridNets.size(); ++netId) {
+        if (mBg.isRouteCongested(this->mGridNets.at(netId))) {
+            rerouteNetIds.at(netId) = true;
+            ++numConflictingNets;
+        }
+    }
+    if (numConflictingNets == 0 || neighborMargin <= 0) {
+        return numConflictingNets;
+    }
+
+    // Neighbors of the conflicts, so that the conflicting nets have room to move
+    std::vector<char> nearConflictCells;
+    mBg.getCongestionNeighborhood(neighborMargin, nearConflictCells);
+    for (std::size_t netId = 0; netId < this->mGridNets.size(); ++netId) {
+        if (!rerouteNetIds.at(netId) && mBg.isRouteInFlaggedCells(this->mGridNets.at(netId), nearConflictCells)) {
+            rerouteNetIds.at(netId) = true;
+            ++numConflictingNets;
+        }
+    }
+    return numConflictingNets;
+}
+
+bool GridBasedRouter::isOverflowFree(std::string &stopReason) {
+    if (!GlobalParam::gStopOnZeroOverflow) {
+        return false;
+    }
+    int numCongestedCells = 0;
+    if (mBg.getOverflow(numCongestedCells) != 0) {
+        return false;
+    }
+    stopReason = "no overlap remains";
+    return true;
+}
+
+bool GridBasedRouter::isRipUpReRouteConverged(const double prevBestCost, const double currentCost, const int numIterations,
+                                              const std::chrono::steady_clock::time_point &startTime, int &numStalledIterations, std::string &stopReason) {
+    // Stalled if the best cost isn't improved by gConvergenceThreshold (relatively)
+    double improvement = prevBestCost - currentCost;
+    if (fabs(prevBestCost) > GlobalParam::gEpsilon) {
+        improvement /= fabs(prevBestCost);
+    }
+    if (improvement < GlobalParam::gConvergenceThreshold) {
+        ++numStalledIterations;
+    } else {
+        numStalledIterations = 0;
+    }
+    if (GlobalParam::gConvergencePatience > 0 && numStalledIterations >= static_cast<int>(GlobalParam::gConvergencePatience)) {
+        stopReason = "best cost improved by less than " + std::to_string(GlobalParam::gConvergenceThreshold * 100.0) + "% in " +
+                     std::to_string(numStalledIterations) + " iterations";
+        return true;
+    }
+
+    // Stop if another iteration, as long as the average one so far, would exceed the time budget
+    double elapsedTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    if (GlobalParam::gRipUpReRouteTimeLimit > 0.0 && numIterations > 0 &&
+        elapsedTime + elapsedTime / numIterations > GlobalParam::gRipUpReRouteTimeLimit) {
+        stopReason = "the next iteration would exceed the time budget of " + std::to_string(GlobalParam::gRipUpReRouteTimeLimit) +
+                     " seconds (" + std::to_string(elapsedTime) + " seconds used)";
+        return true;
+    }
+    return false;
+}
+
+void GridBasedRouter::routeSignalNets(const bool ripupRoutedNet, const std::vector<bool> &rerouteNetIds) {
+    if (GlobalParam::gNumRoutingThreads > 0) {
+        this->routeSignalNetsInBatches(ripupRoutedNet, rerouteNetIds);
+        return;
+    }
+
     auto &nets = mDb.getNets();
     for (auto &net : nets) {
         //Diff Pair
@@ -1284,6 +1557,9 @@ void GridBasedRouter::routeSignalNets(const bool ripupRoutedNet) {
         if (gridRoute.isDiffPair()) {
             continue;
         }
+        if (!rerouteNetIds.empty() && !rerouteNetIds.at(net.getId())) {
+            continue;
+        }
 
         // Temporary reomve the pin cost on the cost grid
         mBg.addPinShapeObstacleCostToGrid(gridRoute.mGridPins, -GlobalParam::gPinObstacleCost, true, false, true);
@@ -1305,6 +1581,7 @@ void GridBasedRouter::routeSignalNets(const bool ripupRoutedNet) {
             gridRoute.setCurViaObstacleCost(GlobalParam::gViaInsertionCost);
         } else {
             // Rip-up routed net
+            this->saveRouteBeforeRipUp(gridRoute);
             mBg.ripup_route(gridRoute);
             // Reroute with updated obstacle costs
             gridRoute.addCurTrackObstacleCost(GlobalParam::gStepTraObsCost);
@@ -1319,6 +1596,171 @@ void GridBasedRouter::routeSignalNets(const bool ripupRoutedNet) {
     }
 }
 
+void GridBasedRouter::routeSignalNetsInBatches(const bool ripupRoutedNet, const std::vector<bool> &rerouteNetIds) {
+    std::vector<std::vector<MultipinRoute *> > batches;
+    std::vector<std::vector<GridBox> > windows;
+    this->getNetBatches(rerouteNetIds, batches, windows);
+
+    if (GlobalParam::gReportParallelScaling && !ripupRoutedNet && !this->mParallelScalingReported) {
+        this->reportParallelScaling(batches, windows);
+        this->mParallelScalingReported = true;
+    }
+
+    for (std::size_t batchId = 0; batchId < batches.size(); ++batchId) {
+        auto &batch = batches.at(batchId);
+        for (auto gridRoute : batch) {
+            if (!ripupRoutedNet) {
+                // First Iteration
+                gridRoute->setCurTrackObstacleCost(GlobalParam::gTraceBasicCost);
+                gridRoute->setCurViaObstacleCost(GlobalParam::gViaInsertionCost);
+            } else {
+                // Rip-up routed net
+                this->saveRouteBeforeRipUp(*gridRoute);
+                mBg.ripup_route(*gridRoute);
+                // Reroute with updated obstacle costs
+                gridRoute->addCurTrackObstacleCost(GlobalParam::gStepTraObsCost);
+                gridRoute->addCurViaObstacleCost(GlobalParam::gStepViaObsCost);
+            }
+        }
+
+        // Route the batch, the pin costs are removed/put back inside
+        mBg.routeGridNetsFromScratch(batch, windows.at(batchId), GlobalParam::gNumRoutingThreads, true);
+    }
+}
+
+void GridBasedRouter::reportParallelScaling(std::vector<std::vector<MultipinRoute *> > &batches, const std::vector<std::vector<GridBox> > &windows) {
+    const std::vector<int> threadCounts{1, 2, 4, 8, 16, 32};
+    const SearchStatistics statistics = mBg.getSearchWorkspace().getStatistics();
+    // Only the batches' nets are routed by the trials
+    std::vector<MultipinRoute *> batchRoutes;
+    for (const auto &batch : batches) {
+        batchRoutes.insert(batchRoutes.end(), batch.begin(), batch.end());
+    }
+    std::vector<MultipinRoute> routesBeforeTrials;
+    for (const auto route : batchRoutes) {
+        routesBeforeTrials.push_back(*route);
+    }
+
+    std::vector<MultipinRoute> serialRoutes;
+    std::vector<double> trialTimes;
+    std::vector<bool> trialMatches;
+    for (const int numThreads : threadCounts) {
+        mBg.beginTransaction();
+        auto trialStart = std::chrono::steady_clock::now();
+        for (std::size_t batchId = 0; batchId < batches.size(); ++batchId) {
+            for (auto gridRoute : batches.at(batchId)) {
+                gridRoute->setCurTrackObstacleCost(GlobalParam::gTraceBasicCost);
+                gridRoute->setCurViaObstacleCost(GlobalParam::gViaInsertionCost);
+            }
+            mBg.routeGridNetsFromScratch(batches.at(batchId), windows.at(batchId), numThreads, true);
+        }
+        trialTimes.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - trialStart).count());
+
+        if (serialRoutes.empty()) {
+            for (const auto route : batchRoutes) {
+                serialRoutes.push_back(*route);
+            }
+        }
+        bool isSameResult = true;
+        for (std::size_t i = 0; i < batchRoutes.size(); ++i) {
+            isSameResult = isSameResult && batchRoutes.at(i)->hasSameRoutingResult(serialRoutes.at(i));
+        }
+        trialMatches.push_back(isSameResult);
+
+        mBg.rollbackTransaction();
+        for (std::size_t i = 0; i < batchRoutes.size(); ++i) {
+            *batchRoutes.at(i) = routesBeforeTrials.at(i);
+        }
+    }
+    mBg.getSearchWorkspace().getStatistics() = statistics;
+    mBg.resetParallelRoutingStatistics();
+
+    std::size_t maxBatchSize = 0;
+    for (const auto &batch : batches) {
+        maxBatchSize = std::max(maxBatchSize, batch.size());
+    }
+    std::cout << std::endl
+              << "Parallel scaling of " << batches.size() << " batches (largest: " << maxBatchSize << " nets), "
+              << std::thread::hardware_concurrency() << " hardware threads:" << std::endl;
+    std::cout << "#threads\ttime (s)\tspeedup\tsame result as 1 thread" << std::endl;
+    for (std::size_t i = 0; i < threadCounts.size(); ++i) {
+        std::cout << threadCounts.at(i) << "\t" << trialTimes.at(i) << "\t" << trialTimes.front() / trialTimes.at(i) << "\t"
+                  << (trialMatches.at(i) ? "yes" : "no") << std::endl;
+    }
+}
+
+void GridBasedRouter::getNetBatches(const std::vector<bool> &rerouteNetIds, std::vector<std::vector<MultipinRoute *> > &batches,
+                                    std::vector<std::vector<GridBox> > &windows) {
+    // First-fit in the net order: a net joins the first batch in which its expanded bounding box
+    // intersects none of the others. The batches only depend on the nets, not on the number of threads
+    std::vector<std::vector<box_int_t> > batchBoxes;
+    batches.clear();
+    windows.clear();
+
+    auto &nets = mDb.getNets();
+    for (auto &net : nets) {
+        if (net.getPins().size() < 2)
+            continue;
+
+        auto &gridRoute = this->mGridNets.at(net.getId());
+        if (gridRoute.isDiffPair() || gridRoute.mGridPins.size() < 2) {
+            continue;
+        }
+        if (!rerouteNetIds.empty() && !rerouteNetIds.at(net.getId())) {
+            continue;
+        }
+        if (!mDb.isNetclassId(net.getNetclassId())) {
+            std::cerr << __FUNCTION__ << "() Invalid netclass id: " << net.getNetclassId() << std::endl;
+            continue;
+        }
+
+        // The search window is the pins' bounding box expanded by the search margin. The cells read by the search
+        // are in the window expanded by the clearance and the trace/via size, this box must not intersect the others
+        const auto &gridNetclass = mBg.getGridNetclass(gridRoute.getGridNetclassId());
+        int expansion = gridNetclass.getClearance() + std::max(gridNetclass.getHalfTraceWidth(), gridNetclass.getHalfViaDia());
+        int minX = std::numeric_limits<int>::max();
+        int minY = std::numeric_limits<int>::max();
+        int maxX = std::numeric_limits<int>::min();
+        int maxY = std::numeric_limits<int>::min();
+        for (const auto &gridPin : gridRoute.mGridPins) {
+            minX = std::min(minX, gridPin.getPinLL().x());
+            minY = std::min(minY, gridPin.getPinLL().y());
+            maxX = std::max(maxX, gridPin.getPinUR().x());
+            maxY = std::max(maxY, gridPin.getPinUR().y());
+        }
+        GridBox window;
+        window.minX = minX - static_cast<int>(GlobalParam::gParallelRoutingMargin);
+        window.minY = minY - static_cast<int>(GlobalParam::gParallelRoutingMargin);
+        window.maxX = maxX + static_cast<int>(GlobalParam::gParallelRoutingMargin);
+        window.maxY = maxY + static_cast<int>(GlobalParam::gParallelRoutingMargin);
+        box_int_t netBox{point_int_t{window.minX - expansion, window.minY - expansion}, point_int_t{window.maxX + expansion, window.maxY + expansion}};
+
+        size_t batchId = 0;
+        for (; batchId < batches.size(); ++batchId) {
+            bool intersected = false;
+            for (const auto &box : batchBoxes.at(batchId)) {
+                if (bg::intersects(netBox, box)) {
+                    intersected = true;
+                    break;
+                }
+            }
+            if (!intersected) {
+                break;
+            }
+        }
+        if (batchId == batches.size()) {
+            batches.emplace_back();
+            batchBoxes.emplace_back();
+            windows.emplace_back();
+        }
+        batches.at(batchId).push_back(&gridRoute);
+        batchBoxes.at(batchId).push_back(netBox);
+        windows.at(batchId).push_back(window);
+    }
+
+    std::cout << __FUNCTION__ << "(): #batches: " << batches.size() << ", #threads: " << GlobalParam::gNumRoutingThreads << std::endl;
+}
+
 void GridBasedRouter::route() {
     std::cout << std::fixed << std::setprecision(5);
     std::cout << std::endl
@@ -1330,6 +1772,10 @@ void GridBasedRouter::route() {
     std::string initialMapNameTag = util::getFileNameWoExtension(mDb.getFileName()) + ".initial" + this->getParamsNameTag();
     mBg.printMatPlot(initialMapNameTag);
 
+    if (GlobalParam::gGlobalRouting) {
+        this->setupGlobalRoutingCorridors();
+    }
+
     // Add all nets to grid routes
     double totalCurrentRouteCost = 0.0;
     bestTotalRouteCost = 0.0;
@@ -1376,8 +1822,8 @@ void GridBasedRouter::route() {
     std::vector<double> iterativeCost;
     iterativeCost.push_back(totalCurrentRouteCost);
     bestTotalRouteCost = totalCurrentRouteCost;
-    this->bestSolution = this->mGridNets;
-    routingSolutions.push_back(this->mGridNets);
+    this->bestSolutionVersion = routingSolutions.commit(this->mGridNets);
+    const int firstVersion = this->bestSolutionVersion;
 
     if (GlobalParam::gOutputDebuggingKiCadFile) {
         std::string nameTag = "fristTimeRouteAll";
@@ -1389,7 +1835,14 @@ void GridBasedRouter::route() {
     std::cout << "\n\n======= Start Fixed-Order Rip-Up and Re-Route all nets. =======\n\n";
 
     // Rip-up and Re-route all the nets one-by-one ten times
+    auto ripUpReRouteStart = std::chrono::steady_clock::now();
+    int numStalledIterations = 0;
+    int numIterations = 0;
+    std::string stopReason = "reached the maximum #iterations";
     for (int i = 0; i < static_cast<int>(GlobalParam::gNumRipUpReRouteIteration); ++i) {
+        if (this->isOverflowFree(stopReason)) {
+            break;
+        }
         for (auto &net : nets) {
             //continue;
             if (net.getPins().size() < 2)
@@ -1430,21 +1883,28 @@ void GridBasedRouter::route() {
             std::string mapNameTag = util::getFileNameWoExtension(mDb.getFileName()) + ".i_" + std::to_string(i + 1) + this->getParamsNameTag();
             mBg.printMatPlot(mapNameTag);
         }
+        int version = routingSolutions.commit(this->mGridNets);
+        double prevBestTotalRouteCost = bestTotalRouteCost;
         if (totalCurrentRouteCost < bestTotalRouteCost) {
             std::cout << "!!!!>!!!!> Found new bestTotalRouteCost: " << totalCurrentRouteCost << ", from: " << bestTotalRouteCost << std::endl;
             bestTotalRouteCost = totalCurrentRouteCost;
-            this->bestSolution = this->mGridNets;
+            this->bestSolutionVersion = version;
         }
-        routingSolutions.push_back(this->mGridNets);
         iterativeCost.push_back(totalCurrentRouteCost);
+        ++numIterations;
         std::cout << "i=" << i + 1 << ", totalCurrentRouteCost: " << totalCurrentRouteCost << ", bestTotalRouteCost: " << bestTotalRouteCost << std::endl;
+
+        if (this->isRipUpReRouteConverged(prevBestTotalRouteCost, totalCurrentRouteCost, numIterations, ripUpReRouteStart, numStalledIterations, stopReason)) {
+            break;
+        }
     }
+    std::cout << "Rip-up and re-route stopped after " << numIterations << " iterations: " << stopReason << std::endl;
     std::cout << "\n\n======= Rip-up and Re-route cost breakdown =======" << std::endl;
     for (std::size_t i = 0; i < iterativeCost.size(); ++i) {
         cout << "i=" << i << ", cost: " << iterativeCost.at(i)
-             << ", WL: " << this->get_routed_wirelength(routingSolutions.at(i))
-             << ", #Vias: " << this->get_routed_num_vias(routingSolutions.at(i))
-             << ", #Bends: " << this->get_routed_num_bends(routingSolutions.at(i));
+             << ", WL: " << routingSolutions.getRoutedWirelength(firstVersion + i)
+             << ", #Vias: " << routingSolutions.getRoutedNumVias(firstVersion + i)
+             << ", #Bends: " << routingSolutions.getRoutedNumBends(firstVersion + i);
 
         if (fabs(bestTotalRouteCost - iterativeCost.at(i)) < GlobalParam::gEpsilon) {
             cout << " <- best result" << std::endl;
@@ -1452,6 +1912,9 @@ void GridBasedRouter::route() {
             cout << std::endl;
         }
     }
+    std::cout << "Solution history: " << routingSolutions.getNumVersions() << " versions, #stored nets: " << routingSolutions.getNumStoredRoutes()
+              << ", #shared nets: " << routingSolutions.getNumSharedRoutes() << std::endl;
+    routingSolutions.restore(this->bestSolutionVersion, this->bestSolution);
 
     std::cout << "\n\n======= Finished Routing all nets. =======\n\n"
               << std::endl;
@@ -2,16 +2,20 @@
 #ifndef PCBROUTER_GRID_BASED_ROUTER_H
 #define PCBROUTER_GRID_BASED_ROUTER_H
 
+#include <chrono>
 #include <cstdio>
 #include <fstream>
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include "BoardGrid.h"
+#include "GlobalRoutingGrid.h"
 #include "GridDiffPairNet.h"
 #include "PcbRouterBoost.h"
+#include "SolutionHistory.h"
 #include "globalParam.h"
 #include "kicadPcbDataBase.h"
 #include "util.h"
@@ -35,6 +39,50 @@ class GridBasedRouter {
     }
     void set_num_iterations(const int _numRRI) { GlobalParam::gNumRipUpReRouteIteration = abs(_numRRI); }
     void set_enlarge_boundary(const int _eB) { GlobalParam::enlargeBoundary = abs(_eB); }
+    void set_search_epoch_reset(const bool _ser) { GlobalParam::gSearchEpochReset = _ser; }
+    void set_row_prefix_sum_cost(const bool _rpsc) { GlobalParam::gRowPrefixSumCost = _rpsc; }
+    void set_frontier_type(const int _ft) {
+        if (_ft >= FrontierType::BINARY_HEAP && _ft <= FrontierType::RADIX_QUEUE) GlobalParam::gFrontierType = static_cast<FrontierType>(_ft);
+    }
+    void set_radix_queue_key_scale(const double _rqks) { GlobalParam::gRadixQueueKeyScale = abs(_rqks); }
+    void set_num_threads(const int _nt) { GlobalParam::gNumRoutingThreads = abs(_nt); }
+    void set_parallel_routing_margin(const int _prm) { GlobalParam::gParallelRoutingMargin = abs(_prm); }
+    void set_negotiated_congestion(const bool _nc) { GlobalParam::gNegotiatedCongestion = _nc; }
+    void set_present_congestion_weight(const double _pcw) { GlobalParam::gPresentCongestionCost = abs(_pcw); }
+    void set_present_congestion_growth(const double _pcg) { GlobalParam::gPresentCongestionGrowth = abs(_pcg); }
+    void set_history_congestion_weight(const double _hcw) { GlobalParam::gHistoryCongestionCost = abs(_hcw); }
+    void set_selective_ripup(const bool _sr) { GlobalParam::gSelectiveRipUp = _sr; }
+    void set_conflict_neighbor_margin(const int _cnm) { GlobalParam::gConflictNeighborMargin = abs(_cnm); }
+    void set_bounded_search_window(const bool _bsw) { GlobalParam::gBoundedSearchWindow = _bsw; }
+    void set_search_window_margin(const int _swm) { GlobalParam::gSearchWindowMargin = abs(_swm); }
+    void set_persistent_via_cost(const bool _pvc) { GlobalParam::gPersistentViaCost = _pvc; }
+    void set_persistent_trace_cost(const bool _ptc) { GlobalParam::gPersistentTraceCost = _ptc; }
+    void set_base_cost_journal(const bool _bcj) { GlobalParam::gBaseCostJournal = _bcj; }
+    void set_backtrack_to_segments(const bool _bts) { GlobalParam::gBacktrackToSegments = _bts; }
+    void set_multi_terminal_search(const bool _mts) { GlobalParam::gMultiTerminalSearch = _mts; }
+    void set_incremental_search(const bool _is) { GlobalParam::gIncrementalSearch = _is; }
+    void set_steiner_tree_pin_ordering(const bool _stpo) { GlobalParam::gSteinerTreePinOrdering = _stpo; }
+    void set_steiner_tree_max_pins(const unsigned int _stmp) { GlobalParam::gSteinerTreeMaxPins = _stmp; }
+    void set_steiner_point_targets(const bool _spt) { GlobalParam::gSteinerPointTargets = _spt; }
+    void set_global_routing(const bool _gr) { GlobalParam::gGlobalRouting = _gr; }
+    void set_gcell_size(const unsigned int _gs) { GlobalParam::gGCellSize = _gs; }
+    void set_corridor_margin(const unsigned int _cm) { GlobalParam::gCorridorMargin = _cm; }
+    void set_gcell_overflow_cost(const double _goc) { GlobalParam::gGCellOverflowCost = _goc; }
+    void set_hierarchical_search(const bool _hs) { GlobalParam::gHierarchicalSearch = _hs; }
+    void set_hierarchical_search_level(const unsigned int _hsl) { GlobalParam::gHierarchicalSearchLevel = _hsl; }
+    void set_hierarchical_band_margin(const unsigned int _hbm) { GlobalParam::gHierarchicalBandMargin = _hbm; }
+    void set_convergence_threshold(const double _ct) { GlobalParam::gConvergenceThreshold = abs(_ct); }
+    void set_convergence_patience(const int _cp) { GlobalParam::gConvergencePatience = abs(_cp); }
+    void set_stop_on_zero_overflow(const bool _szo) { GlobalParam::gStopOnZeroOverflow = _szo; }
+    void set_ripup_reroute_time_limit(const double _rrtl) { GlobalParam::gRipUpReRouteTimeLimit = abs(_rrtl); }
+    void set_speculative_ripup_reroute(const bool _srr) { GlobalParam::gSpeculativeRipUpReRoute = _srr; }
+    void set_report_parallel_scaling(const bool _rps) { GlobalParam::gReportParallelScaling = _rps; }
+    void set_cost_cache_tile_size(const int _ccts) {
+        if (_ccts > 0) GlobalParam::gCostCacheTileSize = _ccts;
+    }
+    void set_search_window_growth(const double _swg) {
+        if (_swg > 1.0) GlobalParam::gSearchWindowGrowth = _swg;
+    }
 
     void set_wirelength_weight(const double _ww) { GlobalParam::gWirelengthCost = abs(_ww); }
     void set_diagonal_wirelength_weight(const double _dww) { GlobalParam::gDiagonalCost = abs(_dww); }
@@ -56,6 +104,44 @@ class GridBasedRouter {
     unsigned int get_grid_scale() { return GlobalParam::inputScale; }
     unsigned int get_num_iterations() { return GlobalParam::gNumRipUpReRouteIteration; }
     unsigned int get_enlarge_boundary() { return GlobalParam::enlargeBoundary; }
+    bool get_search_epoch_reset() { return GlobalParam::gSearchEpochReset; }
+    bool get_row_prefix_sum_cost() { return GlobalParam::gRowPrefixSumCost; }
+    int get_frontier_type() { return GlobalParam::gFrontierType; }
+    double get_radix_queue_key_scale() { return GlobalParam::gRadixQueueKeyScale; }
+    unsigned int get_num_threads() { return GlobalParam::gNumRoutingThreads; }
+    unsigned int get_parallel_routing_margin() { return GlobalParam::gParallelRoutingMargin; }
+    bool get_negotiated_congestion() { return GlobalParam::gNegotiatedCongestion; }
+    double get_present_congestion_weight() { return GlobalParam::gPresentCongestionCost; }
+    double get_present_congestion_growth() { return GlobalParam::gPresentCongestionGrowth; }
+    double get_history_congestion_weight() { return GlobalParam::gHistoryCongestionCost; }
+    bool get_selective_ripup() { return GlobalParam::gSelectiveRipUp; }
+    unsigned int get_conflict_neighbor_margin() { return GlobalParam::gConflictNeighborMargin; }
+    bool get_bounded_search_window() { return GlobalParam::gBoundedSearchWindow; }
+    unsigned int get_search_window_margin() { return GlobalParam::gSearchWindowMargin; }
+    double get_search_window_growth() { return GlobalParam::gSearchWindowGrowth; }
+    bool get_persistent_via_cost() { return GlobalParam::gPersistentViaCost; }
+    bool get_persistent_trace_cost() { return GlobalParam::gPersistentTraceCost; }
+    bool get_base_cost_journal() { return GlobalParam::gBaseCostJournal; }
+    bool get_backtrack_to_segments() { return GlobalParam::gBacktrackToSegments; }
+    bool get_multi_terminal_search() { return GlobalParam::gMultiTerminalSearch; }
+    bool get_incremental_search() { return GlobalParam::gIncrementalSearch; }
+    bool get_steiner_tree_pin_ordering() { return GlobalParam::gSteinerTreePinOrdering; }
+    unsigned int get_steiner_tree_max_pins() { return GlobalParam::gSteinerTreeMaxPins; }
+    bool get_steiner_point_targets() { return GlobalParam::gSteinerPointTargets; }
+    bool get_global_routing() { return GlobalParam::gGlobalRouting; }
+    unsigned int get_gcell_size() { return GlobalParam::gGCellSize; }
+    unsigned int get_corridor_margin() { return GlobalParam::gCorridorMargin; }
+    double get_gcell_overflow_cost() { return GlobalParam::gGCellOverflowCost; }
+    bool get_hierarchical_search() { return GlobalParam::gHierarchicalSearch; }
+    unsigned int get_hierarchical_search_level() { return GlobalParam::gHierarchicalSearchLevel; }
+    unsigned int get_hierarchical_band_margin() { return GlobalParam::gHierarchicalBandMargin; }
+    double get_convergence_threshold() { return GlobalParam::gConvergenceThreshold; }
+    unsigned int get_convergence_patience() { return GlobalParam::gConvergencePatience; }
+    bool get_stop_on_zero_overflow() { return GlobalParam::gStopOnZeroOverflow; }
+    double get_ripup_reroute_time_limit() { return GlobalParam::gRipUpReRouteTimeLimit; }
+    bool get_speculative_ripup_reroute() { return GlobalParam::gSpeculativeRipUpReRoute; }
+    bool get_report_parallel_scaling() { return GlobalParam::gReportParallelScaling; }
+    int get_cost_cache_tile_size() { return GlobalParam::gCostCacheTileSize; }
 
     double get_wirelength_weight() { return GlobalParam::gWirelengthCost; }
     double get_diagonal_wirelength_weight() { return GlobalParam::gDiagonalCost; }
@@ -77,9 +163,35 @@ class GridBasedRouter {
 
    private:
     void testRouterWithPinShape();
-    void routeSingleIteration(const bool ripupRoutedNet = false);
-    void routeDiffPairs(const bool ripupRoutedNet = false);
-    void routeSignalNets(const bool ripupRoutedNet = false);
+    // Global routing on GCells, gives every net the corridor its detailed searches are kept in
+    void setupGlobalRoutingCorridors();
+    // rerouteNetIds: flags indexed by net id, only the flagged nets are routed if not empty
+    void routeSingleIteration(const bool ripupRoutedNet = false, const std::vector<bool> &rerouteNetIds = std::vector<bool>());
+    void routeDiffPairs(const bool ripupRoutedNet = false, const std::vector<bool> &rerouteNetIds = std::vector<bool>());
+    void routeSignalNets(const bool ripupRoutedNet = false, const std::vector<bool> &rerouteNetIds = std::vector<bool>());
+    void routeSignalNetsInBatches(const bool ripupRoutedNet = false, const std::vector<bool> &rerouteNetIds = std::vector<bool>());
+    void getNetBatches(const std::vector<bool> &rerouteNetIds, std::vector<std::vector<MultipinRoute *> > &batches,
+                       std::vector<std::vector<GridBox> > &windows);
+    // Routes the batches with 1 to 32 threads, prints the times and whether the results match the serial one.
+    // Every trial is rolled back, the routes and the search statistics are left as before
+    void reportParallelScaling(std::vector<std::vector<MultipinRoute *> > &batches, const std::vector<std::vector<GridBox> > &windows);
+    // Negotiated congestion iteration, returns false if no overlap remains
+    bool routeCongestedNets(const int iteration);
+    // Selective rip-up iteration, returns false if no net is in conflict
+    bool routeConflictingNets(const int iteration);
+    // Flags the nets sharing grids with others, and the nets within neighborMargin grids of those conflicts
+    int getConflictingNets(const int neighborMargin, std::vector<bool> &rerouteNetIds);
+    // Speculative rip-up and re-route: a route is saved right before an iteration rips it up (only while
+    // mSaveRoutesBeforeRipUp is set), onGrid if its paths are charged to the grid. A rejected iteration puts the saved
+    // routes back with the grid rolled back, in O(#ripped-up nets). They are then charged at the obstacle costs
+    // escalated by the rejected iteration, so that the next one differs
+    void saveRouteBeforeRipUp(MultipinRoute &route, const bool onGrid = true);
+    void restoreRoutesOfRejectedIteration();
+    void clearRoutesSavedBeforeRipUp();
+    // Stop criteria of rip-up and re-route, checked before an iteration (no overlap) and after it (stalled cost, time budget)
+    bool isOverflowFree(std::string &stopReason);
+    bool isRipUpReRouteConverged(const double prevBestCost, const double currentCost, const int numIterations,
+                                 const std::chrono::steady_clock::time_point &startTime, int &numStalledIterations, std::string &stopReason);
 
     bool writeNetsFromGridPaths(std::vector<MultipinRoute> &multipinNets, std::ofstream &ofs);  //deprectaed
     void writeSolutionBackToDbAndSaveOutput(const std::string fileNameTag, std::vector<MultipinRoute> &multipinNets);
@@ -152,10 +264,22 @@ class GridBasedRouter {
     std::vector<GridPin> mGridPins;
 
     // Routing results from iterations
-    std::vector<MultipinRoute> mGridNets;                       //Current routing structures to the board grid
-    std::vector<MultipinRoute> bestSolution;                    //Keep the best routing solutions
-    std::vector<std::vector<MultipinRoute> > routingSolutions;  //Keep the routing solutions of each iteration
+    std::vector<MultipinRoute> mGridNets;     //Current routing structures to the board grid
+    std::vector<MultipinRoute> bestSolution;  //Keep the best routing solutions, restored from routingSolutions at the end
+    SolutionHistory routingSolutions;         //Keep the routing solutions of each iteration, unchanged nets are shared
+    int bestSolutionVersion = 0;              //Version of the best routing solution in routingSolutions
     double bestTotalRouteCost = -1.0;
+    bool mParallelScalingReported = false;
+
+    // Routes saved before their rip-up in a speculative iteration
+    struct SavedRoute {
+        MultipinRoute *route;
+        MultipinRoute savedRoute;
+        bool onGrid;
+    };
+    bool mSaveRoutesBeforeRipUp = false;
+    std::vector<SavedRoute> mRoutesBeforeRipUp;
+    std::unordered_set<const MultipinRoute *> mRipUpRoutes;
 
     // Diff pairs
     std::vector<GridDiffPairNet> mGridDiffPairNets;
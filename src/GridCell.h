@@ -13,38 +13,30 @@ enum GridCellType {
     TARGET_PIN  //Temporary flag, Should be a bool in GridCell? change to PAD_TARGET_PIN?
 };
 
-// struct NeighborCell {
-// };
-
-class GridCell {
-   public:
-    //ctor
-    GridCell() {}
-    //dtor
-    ~GridCell() {}
-
-    friend class BoardGrid;
-
-   private:
-    float baseCost = 0.0;     //Record Routed Nets's traces
+// Per-cell data is kept as separate planes (structure of arrays): BoardGrid holds
+// the base cost, cell type and number of traces, SearchWorkspace the search state
+// and cached costs. The cost kernels only read the base cost, so they stream through
+// a dense float array.
+
+// Search state of a cell. Valid only when searchStamp equals SearchWorkspace's search
+// epoch, otherwise the cell reads as workingCost = inf, bendingCost = 0, cameFromId = -1,
+// frontierKey = inf and not expanded.
+struct GridCellSearchState {
     float workingCost = 0.0;  //Walked Cost
+    int bendingCost = 0;      // # Bending
+    int cameFromId = -1;
+    unsigned int searchStamp = 0;
+    // Key of the cell's latest frontier entry, -inf once the entry is expanded
+    float frontierKey = 0.0;
+    bool expanded = false;
+};
 
-    // // Working cost breakdown
-    // float overlappingCost = 0.0;  // cost of overlapping
-    // float wirelengthCost = 0.0;   // walked distance
-    // float historyCost = 0.0;      // overlapping/overflow cost from previous iteration
-    int bendingCost = 0.0;  // # Bending
-    // int viaCost = 0.0;            // # Vias
-
-    // For incremental cost calculation
+// For incremental cost calculation. Valid only when cacheStamp equals SearchWorkspace's
+// cache epoch, otherwise both costs read as -1.
+struct GridCellCachedCosts {
     float cachedTraceCost = -1.0;
     float cachedViaCost = -1.0;
-
-    int cameFromId = -1;
-    GridCellType cellType = VACANT;
-    int numTraces = 0;
-    //bool targetedPin = false;
-    //bool viaForbidden = false;
+    unsigned int cacheStamp = 0;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -113,7 +113,7 @@ void GridDiffPairNet::separateGridPath(const GridPath &path, const int traceClr,
     auto &locsR = gpNetR.setSegments();
 
     auto prevPointIte = segs.begin();
-    auto pointIte = ++segs.begin();
+    auto pointIte = std::next(segs.begin());
     auto nextPointIte = std::next(pointIte, 1);
 
     // Handle Middle Points
@@ -179,8 +179,8 @@ void GridDiffPairNet::separateGridPath(const GridPath &path, const int traceClr,
         Location startR{segs.front()};
         // Note: Swap next/prev iterators and endL/R
         this->endLocByStartEndLocations(*(std::next(segs.begin())), segs.front(), locsR.front(), locsL.front(), traceClr, traceDiagOffset, startR, startL);
-        locsL.emplace_front(startL);
-        locsR.emplace_front(startR);
+        locsL.emplace(locsL.begin(), startL);
+        locsR.emplace(locsR.begin(), startR);
 
         // Handle Last Point
         Location endL{*(std::prev(segs.end()))};
@@ -216,7 +216,7 @@ void GridDiffPairNet::separateGridPath(const GridPath &path, const int traceClr,
 
 void GridDiffPairNet::locsForStartEndLocationsWithoutMiddlePoints(const Location &start, const Location &end,
                                                                   const int traceClr, const int traceDiagClr,
-                                                                  std::list<Location> &locsL, std::list<Location> &locsR) {
+                                                                  std::vector<Location> &locsL, std::vector<Location> &locsR) {
     // Vertical  end
     //            ^
     //          start
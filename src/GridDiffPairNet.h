@@ -36,7 +36,7 @@ class GridDiffPairNet : public MultipinRoute {
                                    const int traceClr, const int traceDiagOffset, Location &endL, Location &endR);
     void locsForStartEndLocationsWithoutMiddlePoints(const Location &start, const Location &end,
                                                      const int traceClr, const int traceDiagClr,
-                                                     std::list<Location> &locsL, std::list<Location> &locsR);
+                                                     std::vector<Location> &locsL, std::vector<Location> &locsR);
 
    private:
     // int mGridDiffPairNetclassId = -1;
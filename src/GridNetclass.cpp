@@ -88,6 +88,25 @@ void GridNetclass::setupIncrementalSearchGrids(const std::vector<Point_2D<int>>
     getAddDedSearchGrids(searchGrids, searchGridsRF, incrementalSearchGrids.setRFAddGrids(), incrementalSearchGrids.setRFDedGrids());
 }
 
+void GridNetclass::gridsToRowSpans(const std::vector<Point_2D<int>> &grids, std::vector<GridRowSpan> &spans) {
+    spans.clear();
+    std::vector<std::pair<int, int>> sortedGrids;  // (y, x)
+    sortedGrids.reserve(grids.size());
+    for (const auto &pt : grids) {
+        sortedGrids.emplace_back(pt.y(), pt.x());
+    }
+    std::sort(sortedGrids.begin(), sortedGrids.end());
+    sortedGrids.erase(std::unique(sortedGrids.begin(), sortedGrids.end()), sortedGrids.end());
+
+    for (const auto &yx : sortedGrids) {
+        if (!spans.empty() && spans.back().y == yx.first && spans.back().xEnd + 1 == yx.second) {
+            spans.back().xEnd = yx.second;
+        } else {
+            spans.push_back(GridRowSpan{yx.first, yx.second, yx.second});
+        }
+    }
+}
+
 void GridNetclass::getAddDedSearchGrids(const std::vector<Point_2D<int>> &searchGrids, const std::vector<Point_2D<int>> &shiftedSearchGrids, std::vector<Point_2D<int>> &add, std::vector<Point_2D<int>> &ded) {
     // Get add
     for (const auto &pt : shiftedSearchGrids) {
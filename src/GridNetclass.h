@@ -8,6 +8,13 @@
 #include "globalParam.h"
 #include "point.h"
 
+// Horizontal run of grids [xStart, xEnd] at row y, relative to a center grid
+struct GridRowSpan {
+    int y;
+    int xStart;
+    int xEnd;
+};
+
 class GridNetclass {
    public:
     //ctor
@@ -59,14 +66,26 @@ class GridNetclass {
     void setTraceEndShapeGrids(const std::vector<Point_2D<int>> &grids) { mTraceEndShapeToGrids = grids; }
     const std::vector<Point_2D<int>> &getTraceEndShapeToGrids() const { return mTraceEndShapeToGrids; }
     // Trace searching space
-    void setTraceSearchingSpaceToGrids(const std::vector<Point_2D<int>> &grids) { mTraceSearchingSpaceToGrids = grids; }
+    void setTraceSearchingSpaceToGrids(const std::vector<Point_2D<int>> &grids) {
+        mTraceSearchingSpaceToGrids = grids;
+        gridsToRowSpans(grids, mTraceSearchingSpaceSpans);
+    }
     const std::vector<Point_2D<int>> &getTraceSearchingSpaceToGrids() const { return mTraceSearchingSpaceToGrids; }
+    const std::vector<GridRowSpan> &getTraceSearchingSpaceSpans() const { return mTraceSearchingSpaceSpans; }
     // Via searching space
-    void setViaSearchingSpaceToGrids(const std::vector<Point_2D<int>> &grids) { mViaSearchingSpaceToGrids = grids; }
+    void setViaSearchingSpaceToGrids(const std::vector<Point_2D<int>> &grids) {
+        mViaSearchingSpaceToGrids = grids;
+        gridsToRowSpans(grids, mViaSearchingSpaceSpans);
+    }
     const std::vector<Point_2D<int>> &getViaSearchingSpaceToGrids() const { return mViaSearchingSpaceToGrids; }
+    const std::vector<GridRowSpan> &getViaSearchingSpaceSpans() const { return mViaSearchingSpaceSpans; }
+    // Merge relative grids into horizontal spans, duplicated grids are counted once
+    static void gridsToRowSpans(const std::vector<Point_2D<int>> &grids, std::vector<GridRowSpan> &spans);
     // Incremental searching grids
     IncrementalSearchGrids &getTraceIncrementalSearchGrids() { return mTraceIncrementalSearchGrids; }
+    const IncrementalSearchGrids &getTraceIncrementalSearchGrids() const { return mTraceIncrementalSearchGrids; }
     IncrementalSearchGrids &getViaIncrementalSearchGrids() { return mViaIncrementalSearchGrids; }
+    const IncrementalSearchGrids &getViaIncrementalSearchGrids() const { return mViaIncrementalSearchGrids; }
     // Setup the incremental search grids
     void setupViaIncrementalSearchGrids();
     void setupTraceIncrementalSearchGrids();
@@ -107,6 +126,9 @@ class GridNetclass {
     std::vector<Point_2D<int>> mTraceSearchingSpaceToGrids;
     // Via searching space when caluclating grid cost, relative to via center grid
     std::vector<Point_2D<int>> mViaSearchingSpaceToGrids;
+    // Searching spaces above as row spans, for the row prefix-sum cost queries
+    std::vector<GridRowSpan> mTraceSearchingSpaceSpans;
+    std::vector<GridRowSpan> mViaSearchingSpaceSpans;
 
     IncrementalSearchGrids mTraceIncrementalSearchGrids;
     IncrementalSearchGrids mViaIncrementalSearchGrids;
@@ -14,55 +14,29 @@ void GridPath::transformSegmentsToLocations() {
 
     // Check though all the points in segments
     auto pointIte = this->mSegments.begin();
-    auto nextPointIte = ++this->mSegments.begin();
-    this->mLocations.emplace_back(*pointIte);
-
-    for (; nextPointIte != this->mSegments.end();) {
-        if (pointIte->z() != nextPointIte->z()) {
-            // Vias
-            this->mLocations.emplace_back(*nextPointIte);
-        } else {
-            // Traces
-            int diffX = 0;
-            int diffY = 0;
-
-            // Vertical
-            if (pointIte->x() == nextPointIte->x() && pointIte->y() != nextPointIte->y()) {
-                diffY = pointIte->y() > nextPointIte->y() ? -1 : 1;
-            }
-            // Horizontal
-            else if (pointIte->x() != nextPointIte->x() && pointIte->y() == nextPointIte->y()) {
-                diffX = pointIte->x() > nextPointIte->x() ? -1 : 1;
-            }
-            // Diagonal
-            else if (abs(pointIte->x() - nextPointIte->x()) == abs(pointIte->y() - nextPointIte->y())) {
-                diffY = pointIte->y() > nextPointIte->y() ? -1 : 1;
-                diffX = pointIte->x() > nextPointIte->x() ? -1 : 1;
-            } else {
-                if (GlobalParam::gVerboseLevel <= VerboseLevel::WARNING) {
-                    std::cout << __FUNCTION__ << "(): Not a correct 45-degree routing segments" << std::endl
-                              << "Location: " << *pointIte << ", next location: " << *nextPointIte << std::endl;
-
-                    std::cout << "=>All Segment pts:" << std::endl;
-                    for (const auto &pt : this->mSegments) {
-                        std::cout << pt << std::endl;
-                    }
-                    std::cout << "=>End of All Segment pts:" << std::endl;
+    auto nextPointIte = std::next(this->mSegments.begin());
+
+    for (; nextPointIte != this->mSegments.end(); ++pointIte, ++nextPointIte) {
+        if (pointIte->z() == nextPointIte->z() &&
+            pointIte->x() != nextPointIte->x() && pointIte->y() != nextPointIte->y() &&
+            abs(pointIte->x() - nextPointIte->x()) != abs(pointIte->y() - nextPointIte->y())) {
+            if (GlobalParam::gVerboseLevel <= VerboseLevel::WARNING) {
+                std::cout << __FUNCTION__ << "(): Not a correct 45-degree routing segments" << std::endl
+                          << "Location: " << *pointIte << ", next location: " << *nextPointIte << std::endl;
+
+                std::cout << "=>All Segment pts:" << std::endl;
+                for (const auto &pt : this->mSegments) {
+                    std::cout << pt << std::endl;
                 }
-            }
-
-            Location tempLoc{*pointIte};
-            while (tempLoc != *nextPointIte) {
-                tempLoc.m_x += diffX;
-                tempLoc.m_y += diffY;
-                this->mLocations.emplace_back(tempLoc);
+                std::cout << "=>End of All Segment pts:" << std::endl;
             }
         }
-
-        ++pointIte;
-        ++nextPointIte;
     }
 
+    // Expand the segments cell by cell
+    const GridPathCells cells(this->mSegments);
+    this->mLocations.assign(cells.begin(), cells.end());
+
     this->printSegments();
     this->printLocations();
 }
@@ -94,30 +68,21 @@ void GridPath::removeRedundantPoints() {
     // }
     // std::cout << "End of All pts:" << std::endl;
 
-    std::vector<std::list<Location>::iterator> pointsToRemove;
-    auto pointIte = ++this->mSegments.begin();
-    auto prevPointIte = this->mSegments.begin();
-    auto nextPointIte = pointIte;
-    ++nextPointIte;
-
-    for (; nextPointIte != this->mSegments.end();) {
-        // std::cout << "prev: " << *prevPointIte << ", pt: " << *pointIte << ",next: " << *nextPointIte << std::endl;
+    // Compact the kept points in place, comparing each point with its original neighbors
+    Location prevPoint = this->mSegments.front();
+    std::size_t numKeptPoints = 1;
+    for (std::size_t i = 1; i + 1 < this->mSegments.size(); ++i) {
+        const Location point = this->mSegments[i];
+        const Location &nextPoint = this->mSegments[i + 1];
         // Watch out the special case for Via over here
-        if (pointIte->m_x - prevPointIte->m_x == nextPointIte->m_x - pointIte->m_x &&
-            pointIte->m_y - prevPointIte->m_y == nextPointIte->m_y - pointIte->m_y) {
-            // std::cerr << *pointIte << "<= Remove this point" << std::endl;
-            pointsToRemove.push_back(pointIte);
-        } else {
-            //std::cerr << *pointIte << std::endl;
+        if (point.m_x - prevPoint.m_x != nextPoint.m_x - point.m_x ||
+            point.m_y - prevPoint.m_y != nextPoint.m_y - point.m_y) {
+            this->mSegments[numKeptPoints++] = point;
         }
-        ++pointIte;
-        ++nextPointIte;
-        ++prevPointIte;
-    }
-
-    for (auto &&removePt : pointsToRemove) {
-        this->mSegments.erase(removePt);
+        prevPoint = point;
     }
+    this->mSegments[numKeptPoints++] = this->mSegments.back();
+    this->mSegments.resize(numKeptPoints);
 }
 
 double GridPath::getRoutedWirelength() const {
@@ -179,10 +144,9 @@ int GridPath::getRoutedNumBends() const {
     int totalNumBends = 0;
 
     // Check though all the points in segments
-    auto pointIte = ++this->mSegments.begin();
+    auto pointIte = std::next(this->mSegments.begin());
     auto prevPointIte = this->mSegments.begin();
-    auto nextPointIte = pointIte;
-    ++nextPointIte;
+    auto nextPointIte = std::next(pointIte);
 
     for (; nextPointIte != this->mSegments.end();) {
         // Sanity Check
@@ -2,12 +2,86 @@
 #define PCBROUTER_GRID_PATH_H
 
 #include <algorithm>
-#include <list>
+#include <cstddef>
+#include <iterator>
 #include <vector>
 
 #include "globalParam.h"
 #include "point.h"
 
+// Walks the grid cells of an octilinear polyline lazily, one step at a time
+// along each trace and straight to the next point across a via
+class GridPathCellIterator {
+   public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef Location value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const Location *pointer;
+    typedef const Location &reference;
+
+    GridPathCellIterator(const Location *point, const Location *end) : mPoint(point), mEnd(end) {
+        if (mPoint != mEnd) {
+            mCell = *mPoint;
+        }
+    }
+
+    reference operator*() const { return mCell; }
+    pointer operator->() const { return &mCell; }
+
+    GridPathCellIterator &operator++() {
+        // Skip the points already reached (and repeated ones)
+        while (mPoint + 1 != mEnd && mCell == *(mPoint + 1)) {
+            ++mPoint;
+        }
+        if (mPoint + 1 == mEnd) {
+            mPoint = mEnd;
+            return *this;
+        }
+
+        const Location &nextPoint = *(mPoint + 1);
+        if (mCell.m_x == nextPoint.m_x && mCell.m_y == nextPoint.m_y) {
+            // Via
+            mCell.m_z = nextPoint.m_z;
+        } else {
+            // Trace
+            mCell.m_x += (nextPoint.m_x > mCell.m_x) - (nextPoint.m_x < mCell.m_x);
+            mCell.m_y += (nextPoint.m_y > mCell.m_y) - (nextPoint.m_y < mCell.m_y);
+        }
+        return *this;
+    }
+    GridPathCellIterator operator++(int) {
+        GridPathCellIterator ite = *this;
+        ++(*this);
+        return ite;
+    }
+
+    bool operator==(const GridPathCellIterator &other) const {
+        return mPoint == other.mPoint && (mPoint == mEnd || mCell == other.mCell);
+    }
+    bool operator!=(const GridPathCellIterator &other) const { return !(*this == other); }
+
+   private:
+    const Location *mPoint;  // start of the segment being walked
+    const Location *mEnd;
+    Location mCell;
+};
+
+// Range of the cells of a polyline, for range-based for loops
+class GridPathCells {
+   public:
+    explicit GridPathCells(const std::vector<Location> &points) : mPoints(points.data()), mNumPoints(points.size()) {}
+
+    GridPathCellIterator begin() const { return GridPathCellIterator(mPoints, mPoints + mNumPoints); }
+    GridPathCellIterator end() const { return GridPathCellIterator(mPoints + mNumPoints, mPoints + mNumPoints); }
+    bool empty() const { return mNumPoints == 0; }
+
+   private:
+    const Location *mPoints;
+    std::size_t mNumPoints;
+};
+
+// A routed path, as contiguous corner points (mSegments) and, while the net is
+// being routed, the cells found by backtracking (mLocations)
 class GridPath {
    public:
     //ctor
@@ -16,14 +90,19 @@ class GridPath {
     ~GridPath() {}
 
     void addLocation(const Location &l) { mLocations.emplace_back(l); }
-    std::list<Location> &setLocations() { return mLocations; }
-    std::list<Location> &setSegments() { return mSegments; }
+    std::vector<Location> &setLocations() { return mLocations; }
+    std::vector<Location> &setSegments() { return mSegments; }
 
-    const std::list<Location> &getSegments() const { return mSegments; }
-    const std::list<Location> &getLocations() const { return mLocations; }
+    const std::vector<Location> &getSegments() const { return mSegments; }
+    const std::vector<Location> &getLocations() const { return mLocations; }
+    bool isSamePath(const GridPath &other) const { return mSegments == other.mSegments && mLocations == other.mLocations; }
+    // All the cells on the path, expanded lazily from the segments (or the locations before they're turned into segments)
+    GridPathCells getCells() const { return GridPathCells(mSegments.empty() ? mLocations : mSegments); }
 
     void removeRedundantPoints();
     void copyLocationsToSegments() { mSegments = mLocations; }
+    // Drop the per-cell locations, once they are turned into segments
+    void clearLocations() { std::vector<Location>().swap(mLocations); }
     void transformSegmentsToLocations();
     void printLocations() const;
     void printSegments() const;
@@ -36,8 +115,8 @@ class GridPath {
     friend class MultipinRoute;
 
    private:
-    std::list<Location> mLocations;
-    std::list<Location> mSegments;
+    std::vector<Location> mLocations;
+    std::vector<Location> mSegments;
 };
 
-#endif
\ No newline at end of file
+#endif
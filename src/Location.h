@@ -2,10 +2,13 @@
 #define PCBROUTER_LOCATION_H
 
 #include <algorithm>
+#include <cassert>
 #include <queue>
 #include <unordered_set>
 #include <vector>
 
+#include "point.h"
+
 // custom Location priority queue class for search
 template <typename T, typename priority_t>
 struct LocationQueue {
@@ -37,6 +40,27 @@ struct LocationQueue {
     }
 };
 
+// Fixed-capacity, stack-resident neighbor list of a grid location for search:
+// 8 planar neighbors plus one via target per layer (through-hole vias)
+struct NeighborBuffer {
+    static const int kMaxNumLayers = 32;
+    static const int kCapacity = 8 + kMaxNumLayers;
+    typedef std::pair<float, Location> value_type;
+
+    inline void push_back(const value_type &neighbor) {
+        assert(count < kCapacity);
+        elements[count++] = neighbor;
+    }
+    inline void clear() { count = 0; }
+    inline int size() const { return count; }
+    inline bool empty() const { return count == 0; }
+    inline value_type *begin() { return elements; }
+    inline value_type *end() { return elements + count; }
+
+    value_type elements[kCapacity];
+    int count = 0;
+};
+
 // Hash function for Location to support unordered_set
 namespace std {
 template <>
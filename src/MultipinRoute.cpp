@@ -1,5 +1,9 @@
 #include "MultipinRoute.h"
 
+#include <algorithm>
+
+#include "SteinerTree.h"
+
 double MultipinRoute::getRoutedWirelength() const {
     double routedWL = 0.0;
     for (const auto &gp : this->mGridPaths) {
@@ -24,6 +28,22 @@ int MultipinRoute::getRoutedNumBends() const {
     return numRoutedBends;
 }
 
+bool MultipinRoute::hasSameRoutingResult(const MultipinRoute &other) const {
+    if (this->netId != other.netId ||
+        this->currentRouteCost != other.currentRouteCost ||
+        this->curTrackObstacleCost != other.curTrackObstacleCost ||
+        this->curViaObstacleCost != other.curViaObstacleCost ||
+        this->mGridPaths.size() != other.mGridPaths.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < this->mGridPaths.size(); ++i) {
+        if (!this->mGridPaths.at(i).isSamePath(other.mGridPaths.at(i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void MultipinRoute::gridPathSegmentsToLocations() {
     for (auto &&gp : this->mGridPaths) {
         gp.transformSegmentsToLocations();
@@ -31,14 +51,16 @@ void MultipinRoute::gridPathSegmentsToLocations() {
 }
 
 void MultipinRoute::gridPathLocationsToSegments() {
-    // 1. Copy GridPath's Locations into Segments
     for (auto &&gp : this->mGridPaths) {
+        // Backtracked directly into segments
+        if (gp.getLocations().empty()) {
+            continue;
+        }
+        // 1. Copy GridPath's Locations into Segments
         gp.copyLocationsToSegments();
-    }
-
-    // 2. Remove Redundant points in paths
-    for (auto &&gp : this->mGridPaths) {
+        // 2. Remove Redundant points in paths, the cells are then walked from the segments
         gp.removeRedundantPoints();
+        gp.clearLocations();
     }
 }
 
@@ -67,15 +89,13 @@ void MultipinRoute::removeFirstGridPathRedudantLocations() {
         if (disToBack < disToFront) {
             // std::cout << "endOnFirstGp: " << endOnFirstGp << ", gpLocations.back(): " << gpLocations.back() << std::endl;
             // Remove locations in gpLocations from the back
-            while (gpLocations.back() != endOnFirstGp) {
-                gpLocations.pop_back();
-            }
+            auto endIte = std::find(gpLocations.rbegin(), gpLocations.rend(), endOnFirstGp);
+            gpLocations.erase(endIte.base(), gpLocations.end());
         } else {
             // std::cout << "endOnFirstGp: " << endOnFirstGp << ", gpLocations.back(): " << gpLocations.front() << std::endl;
             // Remove locations in gpLocations from the front
-            while (gpLocations.front() != endOnFirstGp) {
-                gpLocations.pop_front();
-            }
+            auto endIte = std::find(gpLocations.begin(), gpLocations.end(), endOnFirstGp);
+            gpLocations.erase(gpLocations.begin(), endIte);
         }
     }
 }
@@ -89,7 +109,7 @@ void MultipinRoute::featuresToGridPaths() {
     // std::cout << "Starting of " << __FUNCTION__ << "() ..." << std::endl;
 
     // Clean up
-    this->mGridPaths.clear();
+    this->clearGridPaths();
 
     if (this->features.size() == 2) {
         auto &&path = this->getNewGridPath();
@@ -154,6 +174,7 @@ void MultipinRoute::featuresToGridPaths() {
 }
 ///<< pin对的距离最小的，由小到大排列
 void MultipinRoute::setupGridPinsRoutingOrder() {
+    this->mSteinerPoints.clear();
     if (this->mGridPins.empty()) {
         return;
     } else if (this->mGridPins.size() == 1) {
@@ -164,11 +185,12 @@ void MultipinRoute::setupGridPinsRoutingOrder() {
         return;
     }
 
+    const int numPins = static_cast<int>(this->mGridPins.size());
     double minLength = std::numeric_limits<double>::max();
     int minLengthId1 = -1;
     int minLengthId2 = -1;
-    for (int i = 0; i < this->mGridPins.size(); ++i) {
-        for (int j = i + 1; j < this->mGridPins.size(); ++j) {
+    for (int i = 0; i < numPins; ++i) {
+        for (int j = i + 1; j < numPins; ++j) {
             double dis = getGridPinsDistance(this->mGridPins[i], this->mGridPins[j]);
             if (dis < minLength) {
                 minLength = dis;
@@ -178,40 +200,129 @@ void MultipinRoute::setupGridPinsRoutingOrder() {
         }
     }
 
-    this->mGridPinsRoutingOrder.push_back(minLengthId1);
-    this->mGridPinsRoutingOrder.push_back(minLengthId2);
+    if (GlobalParam::gSteinerTreePinOrdering && numPins <= static_cast<int>(GlobalParam::gSteinerTreeMaxPins)) {
+        this->setupGridPinsRoutingOrderBySteinerTree(minLengthId1);
+        return;
+    }
 
-    while (mGridPinsRoutingOrder.size() < this->mGridPins.size()) {
-        double minLength = std::numeric_limits<double>::max();
+    // Prim's order: the next pin is the closest one to the ordered pins. Each pin keeps its distance
+    // to the ordered pins, and the position of the first ordered pin at that distance for the ties.
+    std::vector<double> minDistanceToOrdered(numPins, std::numeric_limits<double>::max());
+    std::vector<int> closestOrderedPos(numPins, numPins);
+    std::vector<bool> isOrdered(numPins, false);
+    this->mGridPinsRoutingOrder.clear();
+    this->mGridPinsRoutingOrder.reserve(numPins);
+    auto addToOrder = [this, numPins, &minDistanceToOrdered, &closestOrderedPos, &isOrdered](const int id) {
+        const int pos = static_cast<int>(this->mGridPinsRoutingOrder.size());
+        this->mGridPinsRoutingOrder.push_back(id);
+        isOrdered[id] = true;
+        for (int i = 0; i < numPins; ++i) {
+            if (isOrdered[i]) continue;
+            double dis = getGridPinsDistance(this->mGridPins[i], this->mGridPins[id]);
+            if (dis < minDistanceToOrdered[i]) {
+                minDistanceToOrdered[i] = dis;
+                closestOrderedPos[i] = pos;
+            }
+        }
+    };
+    addToOrder(minLengthId1);
+    addToOrder(minLengthId2);
+
+    while (static_cast<int>(this->mGridPinsRoutingOrder.size()) < numPins) {
         int minLengthId = -1;
-        for (const auto id : mGridPinsRoutingOrder) {
-            for (int i = 0; i < this->mGridPins.size(); ++i) {
-                auto it = std::find(mGridPinsRoutingOrder.begin(), mGridPinsRoutingOrder.end(), i);
-                if (it != mGridPinsRoutingOrder.end()) {
-                    continue;
-                }
-
-                double dis = getGridPinsDistance(this->mGridPins[i], this->mGridPins[id]);
-                if (dis < minLength) {
-                    minLength = dis;
-                    minLengthId = i;
-                }
+        for (int i = 0; i < numPins; ++i) {
+            if (isOrdered[i]) continue;
+            if (minLengthId == -1 || minDistanceToOrdered[i] < minDistanceToOrdered[minLengthId] ||
+                (minDistanceToOrdered[i] == minDistanceToOrdered[minLengthId] && closestOrderedPos[i] < closestOrderedPos[minLengthId])) {
+                minLengthId = i;
             }
         }
-        this->mGridPinsRoutingOrder.push_back(minLengthId);
+        addToOrder(minLengthId);
     }
 
-    std::vector<GridPin> tempGridPins = this->mGridPins;
-    this->mGridPins.clear();
-    for (const auto id : this->mGridPinsRoutingOrder) {
-        //this->mGridPins.emplace_back(std::move(tempGridPins.at(id)));
-        this->mGridPins.push_back(tempGridPins.at(id));
+    this->permuteGridPinsByRoutingOrder();
+}
+
+void MultipinRoute::setupGridPinsRoutingOrderBySteinerTree(const int startPinId) {
+    std::vector<Point_2D<int>> pinCenters;
+    pinCenters.reserve(this->mGridPins.size());
+    for (const auto &gridPin : this->mGridPins) {
+        pinCenters.push_back(gridPin.getPinCenter());
     }
-    if (tempGridPins.size() != this->mGridPins.size()) {
-        if (GlobalParam::gVerboseLevel <= VerboseLevel::CRITICAL) {
-            std::cout << __FUNCTION__ << "(): Failed # of GridPins after reordering..." << std::endl;
+    OctilinearSteinerTree tree;
+    tree.build(pinCenters);
+
+    const int numVertices = static_cast<int>(tree.getVertices().size());
+    std::vector<std::vector<std::pair<double, int>>> adjacentVertices(numVertices);
+    for (const auto &edge : tree.getEdges()) {
+        double length = OctilinearSteinerTree::getDistance(tree.getVertices().at(edge.first), tree.getVertices().at(edge.second));
+        adjacentVertices.at(edge.first).emplace_back(length, edge.second);
+        adjacentVertices.at(edge.second).emplace_back(length, edge.first);
+    }
+
+    // Walk the tree from the start pin, the shortest edge out of the visited vertices first.
+    // Each vertex is reached from its parent, the visited vertex at the other end of that edge.
+    std::vector<double> minEdgeLength(numVertices, std::numeric_limits<double>::max());
+    std::vector<int> parentVertex(numVertices, -1);
+    std::vector<bool> isVisited(numVertices, false);
+    std::vector<int> visitedSteinerPoints;
+    this->mGridPinsRoutingOrder.clear();
+    int vertexId = startPinId;
+    while (vertexId != -1) {
+        isVisited[vertexId] = true;
+        if (tree.isSteinerPoint(vertexId)) {
+            visitedSteinerPoints.push_back(vertexId);
+        } else {
+            this->mGridPinsRoutingOrder.push_back(vertexId);
+        }
+        for (const auto &adjacent : adjacentVertices.at(vertexId)) {
+            if (!isVisited[adjacent.second] && adjacent.first < minEdgeLength[adjacent.second]) {
+                minEdgeLength[adjacent.second] = adjacent.first;
+                parentVertex[adjacent.second] = vertexId;
+            }
         }
+
+        vertexId = -1;
+        for (int i = 0; i < numVertices; ++i) {
+            if (!isVisited[i] && minEdgeLength[i] < std::numeric_limits<double>::max() &&
+                (vertexId == -1 || minEdgeLength[i] < minEdgeLength[vertexId])) {
+                vertexId = i;
+            }
+        }
+    }
+
+    // A Steiner point is routed to right before the first pin of its subtree, which then branches from it.
+    // The pins of the subtree are all visited after the Steiner point, but not the next ones in the walk.
+    std::vector<int> firstSubtreePinPos(numVertices, numVertices);
+    for (int pos = 0; pos < static_cast<int>(this->mGridPinsRoutingOrder.size()); ++pos) {
+        for (int v = parentVertex[this->mGridPinsRoutingOrder[pos]]; v != -1 && firstSubtreePinPos[v] > pos; v = parentVertex[v]) {
+            firstSubtreePinPos[v] = pos;
+        }
+    }
+    for (const int steinerPointId : visitedSteinerPoints) {
+        if (firstSubtreePinPos[steinerPointId] < numVertices) {
+            this->mSteinerPoints.push_back(SteinerPoint{tree.getVertices().at(steinerPointId), firstSubtreePinPos[steinerPointId]});
+        }
+    }
+    // In the routing order, a Steiner point's ancestors first as they are visited before it
+    std::stable_sort(this->mSteinerPoints.begin(), this->mSteinerPoints.end(),
+                     [](const SteinerPoint &sp1, const SteinerPoint &sp2) { return sp1.nextGridPinId < sp2.nextGridPinId; });
+
+    if (GlobalParam::gVerboseLevel <= VerboseLevel::DEBUG) {
+        std::cout << __FUNCTION__ << "(): net " << this->netId << ", # pins: " << tree.getNumTerminals() << ", # Steiner points: " << tree.getNumSteinerPoints()
+                  << ", Steiner tree length: " << tree.getLength() << ", MST length: " << tree.getMstLength() << std::endl;
+    }
+
+    this->permuteGridPinsByRoutingOrder();
+}
+
+void MultipinRoute::permuteGridPinsByRoutingOrder() {
+    std::vector<GridPin> orderedGridPins;
+    orderedGridPins.reserve(this->mGridPinsRoutingOrder.size());
+    for (const auto id : this->mGridPinsRoutingOrder) {
+        orderedGridPins.emplace_back(std::move(this->mGridPins.at(id)));
     }
+    this->mGridPins.swap(orderedGridPins);
 }
 
 double MultipinRoute::getGridPinsDistance(const GridPin &gp1, const GridPin &gp2) {
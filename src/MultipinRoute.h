@@ -11,6 +11,12 @@
 
 class MultipinRoute {
    public:
+    // A Steiner point of the pins' Steiner tree, routed to right before the pin mGridPins[nextGridPinId]
+    struct SteinerPoint {
+        Point_2D<int> point;
+        int nextGridPinId;
+    };
+
     MultipinRoute() {
     }
     MultipinRoute(const int netId) {
@@ -32,6 +38,10 @@ class MultipinRoute {
     void removeFirstGridPathRedudantLocations();
     void removeAcuteAngleBetweenGridPinsAndPaths(const double gridWireWidth);
     void setupGridPinsRoutingOrder();
+    // Route the pins along the octilinear Steiner tree of their centers, the Steiner points become intermediate targets
+    void setupGridPinsRoutingOrderBySteinerTree(const int startPinId);
+    // Permute the pins to the routing order, by moving them
+    void permuteGridPinsByRoutingOrder();
     double getGridPinsDistance(const GridPin &gp1, const GridPin &gp2);
 
     int getGridNetclassId() const { return gridNetclassId; }
@@ -40,7 +50,16 @@ class MultipinRoute {
     const std::vector<pr::prIntCost> &getLayerCosts() const { return mLayerCosts; }
     const std::vector<GridPath> &getGridPaths() const { return mGridPaths; }
     const std::vector<GridPin> &getGridPins() const { return mGridPins; }
-    void clearGridPaths() { mGridPaths.clear(); }
+    const std::vector<SteinerPoint> &getSteinerPoints() const { return mSteinerPoints; }
+    // GCells of the global routing corridor, empty if the searches aren't restricted
+    const std::vector<int> &getSearchCorridor() const { return mSearchCorridor; }
+    void setSearchCorridor(const std::vector<int> &corridor) { mSearchCorridor = corridor; }
+    void clearGridPaths() {
+        mGridPaths.clear();
+        mNumSteinerGridPaths = 0;
+    }
+    // Pins connected by the paths so far (the paths to Steiner points don't connect any pin)
+    int getNumConnectedGridPins() const { return static_cast<int>(mGridPaths.size()) + 1 - mNumSteinerGridPaths; }
 
     GridPath &getNewGridPath() {
         mGridPaths.push_back(GridPath{});
@@ -51,6 +70,9 @@ class MultipinRoute {
         return mGridPins.back();
     }
 
+    // Same paths, route cost and obstacle costs, i.e. the net wasn't re-routed in between
+    bool hasSameRoutingResult(const MultipinRoute &other) const;
+
     double getRoutedWirelength() const;
     int getRoutedNumVias() const;
     int getRoutedNumBends() const;
@@ -85,6 +107,9 @@ class MultipinRoute {
     std::vector<GridPath> mGridPaths;
     std::vector<pr::prIntCost> mLayerCosts;  //Layer preferences for this net, align with board grid layer
     std::vector<int> mGridPinsRoutingOrder;
+    std::vector<SteinerPoint> mSteinerPoints;
+    int mNumSteinerGridPaths = 0;  // paths routed to Steiner points
+    std::vector<int> mSearchCorridor;
     // std::vector<Location> vias; //TODO
 
     // deprecated, will clean up later
@@ -32,7 +32,7 @@ void PostProcessing::removeAcuteAngleBetweenGridPinsAndPaths(const vector<GridPi
                 // 2. start point is within pin polygon (return false when point on the polygon boundary)
                 // 3. (Skip) starting segments intersects pin polygon <= redundant /*bg::intersects(bgFirstLs, gPin.getExpandedPinPolygon()) &&*/
                 auto firstPtIte = segs.begin();
-                auto secondPtIte = ++segs.begin();
+                auto secondPtIte = std::next(segs.begin());
 
                 if (firstPtIte->z() == secondPtIte->z() &&
                     gPin.isConnectedToPin(*firstPtIte)
@@ -92,11 +92,9 @@ void PostProcessing::removeAcuteAngleBetweenGridPinsAndPaths(const vector<GridPi
 
                             // Remove acute angle segments
                             segs.erase(segs.begin(), secondPtIte);
-                            // Update the segments without acute angle
-                            while (!updatedSegments.empty()) {
-                                segs.emplace_front(updatedSegments.front());
-                                updatedSegments.pop_front();
-                            }
+                            // Update the segments without acute angle (pushed to the front one by one)
+                            segs.insert(segs.begin(), updatedSegments.rbegin(), updatedSegments.rend());
+                            updatedSegments.clear();
                             processedFromHead.insert(i);
                             break;
                         }
@@ -109,7 +107,7 @@ void PostProcessing::removeAcuteAngleBetweenGridPinsAndPaths(const vector<GridPi
             // Fix the lost connection due to fixing the acute angle violation
             if (processedFromHead.find(i) == processedFromHead.end()) {
                 auto firstPtIte = segs.begin();
-                auto secondPtIte = ++segs.begin();
+                auto secondPtIte = std::next(segs.begin());
                 if (firstPtIte->z() == secondPtIte->z() &&
                     !gPin.isConnectedToPin(*firstPtIte) &&
                     gPin.isPinLayer(firstPtIte->z()) &&
@@ -160,11 +158,9 @@ void PostProcessing::removeAcuteAngleBetweenGridPinsAndPaths(const vector<GridPi
 
                             // Remove acute angle segments
                             segs.erase(segs.begin(), secondPtIte);
-                            // Update the segments without acute angle
-                            while (!updatedSegments.empty()) {
-                                segs.emplace_front(updatedSegments.front());
-                                updatedSegments.pop_front();
-                            }
+                            // Update the segments without acute angle (pushed to the front one by one)
+                            segs.insert(segs.begin(), updatedSegments.rbegin(), updatedSegments.rend());
+                            updatedSegments.clear();
                             processedFromHead.insert(i);
                             break;
                         }
@@ -0,0 +1,231 @@
+#ifndef PCBROUTER_SEARCH_FRONTIER_H
+#define PCBROUTER_SEARCH_FRONTIER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "Location.h"
+#include "globalParam.h"
+#include "point.h"
+
+// Frontiers of the A* search. All of them share the same interface:
+//   clear(), empty(), size(), push(location, cellId, key), front(), frontKey(), pop(),
+//   resetMonotoneBound()
+// push() of a cell that is already in the frontier either adds a duplicate entry
+// (lazy deletion, stale entries are filtered by the search) or updates the key
+// in place (indexed heap).
+
+// Binary heap on LocationQueue, duplicates are pushed on every improvement
+class BinaryHeapFrontier {
+   public:
+    void clear() { mQueue.elements = decltype(mQueue.elements)(); }
+    bool empty() const { return mQueue.empty(); }
+    size_t size() const { return mQueue.size(); }
+    void push(const Location &loc, const int, const float key) { mQueue.push(loc, key); }
+    Location front() { return mQueue.front(); }
+    float frontKey() { return mQueue.frontKey(); }
+    void pop() { mQueue.pop(); }
+    void resetMonotoneBound() {}
+
+   private:
+    LocationQueue<Location, float> mQueue;
+};
+
+// Indexed 4-ary min-heap keyed by cell id, supports decrease-key (and increase-key)
+class IndexedQuaternaryHeapFrontier {
+   public:
+    // Number of cells, positions are indexed by cell id
+    void setup(const int numCells) {
+        if (static_cast<int>(mPosition.size()) != numCells) {
+            mPosition.assign(numCells, -1);
+            mHeap.clear();
+        }
+    }
+    void clear() {
+        for (const auto &entry : mHeap) {
+            mPosition[entry.id] = -1;
+        }
+        mHeap.clear();
+    }
+    bool empty() const { return mHeap.empty(); }
+    size_t size() const { return mHeap.size(); }
+
+    void push(const Location &loc, const int id, const float key) {
+        int pos = mPosition[id];
+        if (pos < 0) {
+            mHeap.push_back(Entry{key, id, loc});
+            pos = static_cast<int>(mHeap.size()) - 1;
+            mPosition[id] = pos;
+            siftUp(pos);
+        } else if (key < mHeap[pos].key) {
+            mHeap[pos].key = key;
+            siftUp(pos);
+        } else {
+            mHeap[pos].key = key;
+            siftDown(pos);
+        }
+    }
+    Location front() const { return mHeap.front().loc; }
+    float frontKey() const { return mHeap.front().key; }
+    void pop() {
+        mPosition[mHeap.front().id] = -1;
+        if (mHeap.size() > 1) {
+            mHeap.front() = mHeap.back();
+            mPosition[mHeap.front().id] = 0;
+            mHeap.pop_back();
+            siftDown(0);
+        } else {
+            mHeap.pop_back();
+        }
+    }
+    void resetMonotoneBound() {}
+
+   private:
+    struct Entry {
+        float key;
+        int id;
+        Location loc;
+    };
+
+    void siftUp(int pos) {
+        Entry entry = mHeap[pos];
+        while (pos > 0) {
+            int parent = (pos - 1) / 4;
+            if (!(entry.key < mHeap[parent].key)) break;
+            mHeap[pos] = mHeap[parent];
+            mPosition[mHeap[pos].id] = pos;
+            pos = parent;
+        }
+        mHeap[pos] = entry;
+        mPosition[entry.id] = pos;
+    }
+
+    void siftDown(int pos) {
+        Entry entry = mHeap[pos];
+        const int heapSize = static_cast<int>(mHeap.size());
+        while (true) {
+            int firstChild = 4 * pos + 1;
+            if (firstChild >= heapSize) break;
+            int lastChild = std::min(firstChild + 4, heapSize);
+            int minChild = firstChild;
+            for (int child = firstChild + 1; child < lastChild; ++child) {
+                if (mHeap[child].key < mHeap[minChild].key) {
+                    minChild = child;
+                }
+            }
+            if (!(mHeap[minChild].key < entry.key)) break;
+            mHeap[pos] = mHeap[minChild];
+            mPosition[mHeap[pos].id] = pos;
+            pos = minChild;
+        }
+        mHeap[pos] = entry;
+        mPosition[entry.id] = pos;
+    }
+
+    std::vector<Entry> mHeap;
+    std::vector<int> mPosition;  // heap position of each cell id, -1 if not in the heap
+};
+
+// Radix heap on quantized keys (key * GlobalParam::gRadixQueueKeyScale), with lazy deletion.
+// Keys must be monotone, a key below the last popped one is clamped to it.
+// Ties within one quantum are popped in arbitrary order, so the search is approximate.
+class RadixQueueFrontier {
+   public:
+    void clear() {
+        for (auto &bucket : mBuckets) {
+            bucket.clear();
+        }
+        mLast = 0;
+        mSize = 0;
+    }
+    bool empty() const { return mSize == 0; }
+    size_t size() const { return mSize; }
+
+    void push(const Location &loc, const int id, const float key) {
+        uint64_t quantizedKey = quantize(key);
+        if (quantizedKey < mLast) {
+            quantizedKey = mLast;
+        }
+        mBuckets[bucketIndex(quantizedKey)].push_back(Entry{quantizedKey, key, id, loc});
+        ++mSize;
+    }
+    Location front() {
+        pull();
+        return mBuckets[0].back().loc;
+    }
+    float frontKey() {
+        pull();
+        return mBuckets[0].back().key;
+    }
+    void pop() {
+        pull();
+        mBuckets[0].pop_back();
+        --mSize;
+    }
+    // Accept keys below the last popped one again (e.g. new sources of a growing search tree),
+    // the entries are re-bucketed from their original keys
+    void resetMonotoneBound() {
+        if (mLast == 0) return;
+        std::vector<Entry> entries;
+        entries.reserve(mSize);
+        for (auto &bucket : mBuckets) {
+            entries.insert(entries.end(), bucket.begin(), bucket.end());
+            bucket.clear();
+        }
+        mLast = 0;
+        for (auto &entry : entries) {
+            entry.quantizedKey = quantize(entry.key);
+            mBuckets[bucketIndex(entry.quantizedKey)].push_back(entry);
+        }
+    }
+
+   private:
+    struct Entry {
+        uint64_t quantizedKey;
+        float key;
+        int id;
+        Location loc;
+    };
+
+    static uint64_t quantize(const float key) {
+        double scaled = static_cast<double>(key) * GlobalParam::gRadixQueueKeyScale;
+        if (!(scaled > 0.0)) return 0;
+        if (scaled >= static_cast<double>(std::numeric_limits<uint64_t>::max() >> 1)) return std::numeric_limits<uint64_t>::max() >> 1;
+        return static_cast<uint64_t>(scaled);
+    }
+
+    int bucketIndex(const uint64_t quantizedKey) const {
+        if (quantizedKey == mLast) return 0;
+        return 64 - __builtin_clzll(quantizedKey ^ mLast);
+    }
+
+    // Make sure bucket 0 holds the entries of the minimum key
+    void pull() {
+        if (!mBuckets[0].empty()) return;
+        int i = 1;
+        while (mBuckets[i].empty()) {
+            ++i;
+        }
+        uint64_t newLast = mBuckets[i].front().quantizedKey;
+        for (const auto &entry : mBuckets[i]) {
+            newLast = std::min(newLast, entry.quantizedKey);
+        }
+        mLast = newLast;
+        std::vector<Entry> redistributed;
+        redistributed.swap(mBuckets[i]);
+        for (const auto &entry : redistributed) {
+            mBuckets[bucketIndex(entry.quantizedKey)].push_back(entry);
+        }
+        // Keep the emptied vector's capacity for reuse
+        redistributed.clear();
+        mBuckets[i].swap(redistributed);
+    }
+
+    std::vector<Entry> mBuckets[65];
+    uint64_t mLast = 0;
+    size_t mSize = 0;
+};
+
+#endif
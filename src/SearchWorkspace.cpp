@@ -0,0 +1,244 @@
+#include "SearchWorkspace.h"
+
+SearchStatistics &SearchStatistics::operator+=(const SearchStatistics &other) {
+    this->numSearches += other.numSearches;
+    this->numExpansions += other.numExpansions;
+    this->numFrontierPushes += other.numFrontierPushes;
+    this->numStalePops += other.numStalePops;
+    this->numReExpansions += other.numReExpansions;
+    this->viaCachedMissed += other.viaCachedMissed;
+    this->viaCachedHit += other.viaCachedHit;
+    this->numWindowSearches += other.numWindowSearches;
+    this->numWindowRetries += other.numWindowRetries;
+    this->numCorridorSearches += other.numCorridorSearches;
+    this->numCorridorRetries += other.numCorridorRetries;
+    this->numHierarchicalSearches += other.numHierarchicalSearches;
+    this->numHierarchicalRetries += other.numHierarchicalRetries;
+    this->numCoarseExpansions += other.numCoarseExpansions;
+    this->numIncrementalNets += other.numIncrementalNets;
+    this->numResumedSearches += other.numResumedSearches;
+    this->numReusedSettledCells += other.numReusedSettledCells;
+    this->searchTime += other.searchTime;
+    this->searchResetTime += other.searchResetTime;
+    return *this;
+}
+
+void SearchWorkspace::setup(const int w, const int h, const int l) {
+    if (this->w == w && this->h == h && this->l == l) {
+        return;
+    }
+    this->w = w;
+    this->h = h;
+    this->l = l;
+    this->size = w * h * l;
+    this->resetSearchWindowLimit();
+
+    this->mSearchState.assign(this->size, GridCellSearchState());
+    this->mCachedCosts.assign(this->size, GridCellCachedCosts());
+    this->mTargetedPin.assign(this->size, 0);
+    this->mSearchEpoch = 1;
+    this->mCacheEpoch = 1;
+}
+
+void SearchWorkspace::working_cost_fill(float value) {
+    for (int i = 0; i < this->size; ++i) {
+        this->touchSearchState(this->mSearchState[i]);
+        this->mSearchState[i].workingCost = value;
+    }
+}
+
+void SearchWorkspace::bending_cost_fill(float value) {
+    for (int i = 0; i < this->size; ++i) {
+        this->touchSearchState(this->mSearchState[i]);
+        this->mSearchState[i].bendingCost = value;
+    }
+}
+
+void SearchWorkspace::cached_trace_cost_fill(float value) {
+    for (int i = 0; i < this->size; ++i) {
+        this->touchCachedCosts(this->mCachedCosts[i]);
+        this->mCachedCosts[i].cachedTraceCost = value;
+    }
+}
+
+void SearchWorkspace::cached_via_cost_fill(float value) {
+    for (int i = 0; i < this->size; ++i) {
+        this->touchCachedCosts(this->mCachedCosts[i]);
+        this->mCachedCosts[i].cachedViaCost = value;
+    }
+}
+
+void SearchWorkspace::clearAllCameFromId() {
+    for (int i = 0; i < this->size; ++i) {
+        this->touchSearchState(this->mSearchState[i]);
+        this->mSearchState[i].cameFromId = -1;
+    }
+}
+
+void SearchWorkspace::resetSearchState() {
+    ++this->mSearchEpoch;
+    if (this->mSearchEpoch == 0) {
+        // Wrapped around, stamps from 2^32 generations ago would look valid again
+        for (int i = 0; i < this->size; ++i) {
+            this->mSearchState[i].searchStamp = 0;
+        }
+        this->mSearchEpoch = 1;
+    }
+}
+
+void SearchWorkspace::resetCachedCosts() {
+    ++this->mCacheEpoch;
+    if (this->mCacheEpoch == 0) {
+        for (int i = 0; i < this->size; ++i) {
+            this->mCachedCosts[i].cacheStamp = 0;
+        }
+        this->mCacheEpoch = 1;
+    }
+}
+
+void SearchWorkspace::resetSearchStateForNewSearch() {
+    auto resetStart = std::chrono::steady_clock::now();
+    if (GlobalParam::gSearchEpochReset) {
+        this->resetSearchState();
+    } else {
+        this->working_cost_fill(std::numeric_limits<float>::infinity());
+        this->bending_cost_fill(0);
+    }
+    this->mStatistics.searchResetTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - resetStart).count();
+}
+
+void SearchWorkspace::resetCachedCostsForNewRoute() {
+    auto resetStart = std::chrono::steady_clock::now();
+    if (GlobalParam::gSearchEpochReset) {
+        this->resetSearchState();
+        this->resetCachedCosts();
+    } else {
+        this->clearAllCameFromId();
+        this->cached_trace_cost_fill(-1);
+        this->cached_via_cost_fill(-1);
+    }
+    this->mStatistics.searchResetTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - resetStart).count();
+}
+
+void SearchWorkspace::setupCostCaches(const int numNetclasses, const bool viaCost, const bool traceCost,
+                                      const int tileSize, const int numTilesX, const int numTilesY, const std::vector<unsigned int> *boardCostTileVersion) {
+    this->mViaCostCaches.resize(viaCost ? numNetclasses : 0);
+    this->mTraceCostCaches.resize(traceCost ? numNetclasses : 0);
+    for (auto *caches : {&this->mViaCostCaches, &this->mTraceCostCaches}) {
+        for (auto &cache : *caches) {
+            cache.setup(this->w, this->h, this->l, tileSize, numTilesX, numTilesY);
+        }
+    }
+    this->mBoardCostTileVersion = boardCostTileVersion;
+}
+
+void SearchWorkspace::clearCostCaches() {
+    this->mViaCostCaches.clear();
+    this->mTraceCostCaches.clear();
+    this->mBoardCostTileVersion = nullptr;
+}
+
+long long SearchWorkspace::getNumTileRefreshes(const std::vector<CostTileCache> &caches) {
+    long long numRefreshes = 0;
+    for (const auto &cache : caches) {
+        numRefreshes += cache.getNumTileRefreshes();
+    }
+    return numRefreshes;
+}
+
+void SearchWorkspace::setSearchWindow(const int minX, const int minY, const int maxX, const int maxY) {
+    this->mWindowMinX = std::max(minX, this->mLimitMinX);
+    this->mWindowMinY = std::max(minY, this->mLimitMinY);
+    this->mWindowMaxX = std::min(maxX, this->mLimitMaxX);
+    this->mWindowMaxY = std::min(maxY, this->mLimitMaxY);
+}
+
+void SearchWorkspace::resetSearchWindow() {
+    this->setSearchWindow(this->mLimitMinX, this->mLimitMinY, this->mLimitMaxX, this->mLimitMaxY);
+}
+
+void SearchWorkspace::setSearchWindowLimit(const int minX, const int minY, const int maxX, const int maxY) {
+    this->mLimitMinX = std::max(minX, 0);
+    this->mLimitMinY = std::max(minY, 0);
+    this->mLimitMaxX = std::min(maxX, this->w - 1);
+    this->mLimitMaxY = std::min(maxY, this->h - 1);
+    this->resetSearchWindow();
+}
+
+void SearchWorkspace::resetSearchWindowLimit() {
+    this->setSearchWindowLimit(0, 0, this->w - 1, this->h - 1);
+}
+
+void SearchWorkspace::setSearchCorridor(const std::vector<int> &gcellIds, const int gcellSize) {
+    this->clearSearchCorridor();
+    this->mCorridorGCellSize = gcellSize;
+    this->mNumCorridorGCellsX = (this->w + gcellSize - 1) / gcellSize;
+    const int numGCells = this->mNumCorridorGCellsX * ((this->h + gcellSize - 1) / gcellSize);
+    if (static_cast<int>(this->mCorridorMask.size()) != numGCells) {
+        this->mCorridorMask.assign(numGCells, 0);
+    }
+    this->mCorridorGCellIds = gcellIds;
+    for (const auto id : this->mCorridorGCellIds) {
+        this->mCorridorMask[id] = 1;
+    }
+}
+
+void SearchWorkspace::clearSearchCorridor() {
+    for (const auto id : this->mCorridorGCellIds) {
+        this->mCorridorMask[id] = 0;
+    }
+    this->mCorridorGCellIds.clear();
+    this->mCorridorGCellSize = 0;
+}
+
+void SearchWorkspace::setTargetedPins(const std::vector<Location> &pins) {
+    for (const auto &pin : pins) {
+        this->setTargetedPin(pin);
+    }
+}
+
+void SearchWorkspace::clearTargetedPins(const std::vector<Location> &pins) {
+    for (const auto &pin : pins) {
+        this->clearTargetedPin(pin);
+    }
+}
+
+void SearchWorkspace::setCurrentTargets(const std::vector<Location> &pinWithLayers) {
+    // For early break
+    this->setTargetedPins(pinWithLayers);
+    // For 2D cost estimation (cares about x and y only)
+    this->current_targeted_pin = pinWithLayers.front();
+    // For 3D cost estimation
+    this->currentTargetedPinWithLayers = pinWithLayers;
+    // For 2D cost estimation, the layers of a pin are a same target
+    this->mCurrentTargets2D.clear();
+    for (const auto &pin : pinWithLayers) {
+        Location target{pin.m_x, pin.m_y, 0};
+        if (std::find(this->mCurrentTargets2D.begin(), this->mCurrentTargets2D.end(), target) == this->mCurrentTargets2D.end()) {
+            this->mCurrentTargets2D.push_back(target);
+        }
+    }
+}
+
+void SearchWorkspace::clearCurrentTargets() {
+    this->clearTargetedPins(this->currentTargetedPinWithLayers);
+    this->current_targeted_pin = Location{0, 0, 0};
+    this->currentTargetedPinWithLayers.clear();
+    this->mCurrentTargets2D.clear();
+}
+
+bool SearchWorkspace::closeFrontierEntry(const Location &l, const float key) {
+    GridCellSearchState &state = this->mSearchState[this->locationToId(l)];
+    if (state.searchStamp != this->mSearchEpoch || state.frontierKey != key) {
+        // Stale entry: the cell has been improved (or expanded) after this entry was pushed
+        ++this->mStatistics.numStalePops;
+        return false;
+    }
+    state.frontierKey = -std::numeric_limits<float>::infinity();
+    if (state.expanded) {
+        ++this->mStatistics.numReExpansions;
+    }
+    state.expanded = true;
+    ++this->mStatistics.numExpansions;
+    return true;
+}
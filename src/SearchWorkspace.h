@@ -0,0 +1,308 @@
+#ifndef PCBROUTER_SEARCH_WORKSPACE_H
+#define PCBROUTER_SEARCH_WORKSPACE_H
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include "CostTileCache.h"
+#include "GridCell.h"
+#include "Location.h"
+#include "SearchFrontier.h"
+#include "globalParam.h"
+#include "point.h"
+
+// Box of grid cells, [minX, maxX] x [minY, maxY]
+struct GridBox {
+    int minX = 0;
+    int minY = 0;
+    int maxX = -1;
+    int maxY = -1;
+};
+
+// Counters of the A* searches done in a workspace
+struct SearchStatistics {
+    long long numSearches = 0;
+    long long numExpansions = 0;
+    long long numFrontierPushes = 0;
+    long long numStalePops = 0;
+    long long numReExpansions = 0;
+    long long viaCachedMissed = 0;
+    long long viaCachedHit = 0;
+    long long numWindowSearches = 0;  // connections searched in a bounded window
+    long long numWindowRetries = 0;   // searches redone in a larger window
+    long long numCorridorSearches = 0;  // connections searched in a global routing corridor
+    long long numCorridorRetries = 0;   // searches redone without the corridor
+    long long numHierarchicalSearches = 0;  // connections refined in the band of a coarse path
+    long long numHierarchicalRetries = 0;   // refinements redone without the band
+    long long numCoarseExpansions = 0;      // cells expanded by the coarse searches
+    long long numIncrementalNets = 0;      // multi-pin nets whose connections resumed the previous search
+    long long numResumedSearches = 0;      // connections searched by resuming the previous search
+    long long numReusedSettledCells = 0;   // cells settled by the previous connections when resuming
+    double searchTime = 0.0;       // seconds spent in aStarSearching(), resets included
+    double searchResetTime = 0.0;  // seconds spent on resetting the per-cell search state
+
+    SearchStatistics &operator+=(const SearchStatistics &other);
+};
+
+// Scratch state of the A* searches: per-cell search state and cached costs, the
+// targeted pins of the current connection, the frontiers and the statistics.
+// BoardGrid only reads its cost grids while searching, and writes every temporary
+// value into the workspace passed in, so each thread can search with its own one.
+class SearchWorkspace {
+   public:
+    //ctor
+    SearchWorkspace() {}
+
+    //dtor
+    ~SearchWorkspace() {}
+
+    // Allocate the planes for a w x h x l grid, keeps the state if the size is unchanged
+    void setup(const int w, const int h, const int l);
+    int getSize() const { return size; }
+
+    // Search state reset by bumping the epochs, O(1) except on wrap-around
+    void resetSearchState();
+    void resetCachedCosts();
+    // Reset at the beginning of a connection/net (epoch or full-grid fill)
+    void resetSearchStateForNewSearch();
+    void resetCachedCostsForNewRoute();
+
+    // working cost
+    void working_cost_fill(float value);
+    inline float working_cost_at(const Location &l) const {
+        const GridCellSearchState &cell = this->mSearchState[this->locationToId(l)];
+        return cell.searchStamp == this->mSearchEpoch ? cell.workingCost : std::numeric_limits<float>::infinity();
+    }
+    inline void working_cost_set(float value, const Location &l) {
+        GridCellSearchState &cell = this->mSearchState[this->locationToId(l)];
+        this->touchSearchState(cell);
+        cell.workingCost = value;
+    }
+    // bending cost
+    void bending_cost_fill(float value);
+    inline float bending_cost_at(const Location &l) const {
+        const GridCellSearchState &cell = this->mSearchState[this->locationToId(l)];
+        return cell.searchStamp == this->mSearchEpoch ? cell.bendingCost : 0;
+    }
+    inline void bending_cost_set(float value, const Location &l) {
+        GridCellSearchState &cell = this->mSearchState[this->locationToId(l)];
+        this->touchSearchState(cell);
+        cell.bendingCost = value;
+    }
+    // cached trace cost, from the current netclass' persistent planes if set up
+    void cached_trace_cost_fill(float value);
+    inline float cached_trace_cost_at(const Location &l) const {
+        if (!this->mTraceCostCaches.empty()) {
+            return this->mTraceCostCaches[this->currentGridNetclassId].at(l.m_x, l.m_y, l.m_z, *this->mBoardCostTileVersion);
+        }
+        const GridCellCachedCosts &cell = this->mCachedCosts[this->locationToId(l)];
+        return cell.cacheStamp == this->mCacheEpoch ? cell.cachedTraceCost : -1.0;
+    }
+    inline void cached_trace_cost_set(float value, const Location &l) {
+        if (!this->mTraceCostCaches.empty()) {
+            this->mTraceCostCaches[this->currentGridNetclassId].set(l.m_x, l.m_y, l.m_z, value);
+            return;
+        }
+        GridCellCachedCosts &cell = this->mCachedCosts[this->locationToId(l)];
+        this->touchCachedCosts(cell);
+        cell.cachedTraceCost = value;
+    }
+    // cached via cost, from the current netclass' persistent planes if set up
+    // (through-hole vias at z = 0, micro vias from z to z + 1 at z)
+    void cached_via_cost_fill(float value);
+    bool hasViaCostCaches() const { return !this->mViaCostCaches.empty(); }
+    inline float cached_via_cost_at(const Location &l) const {
+        if (!this->mViaCostCaches.empty()) {
+            return this->mViaCostCaches[this->currentGridNetclassId].at(l.m_x, l.m_y, l.m_z, *this->mBoardCostTileVersion);
+        }
+        const GridCellCachedCosts &cell = this->mCachedCosts[this->locationToId(l)];
+        return cell.cacheStamp == this->mCacheEpoch ? cell.cachedViaCost : -1.0;
+    }
+    inline void cached_via_cost_set(float value, const Location &l) {
+        if (!this->mViaCostCaches.empty()) {
+            this->mViaCostCaches[this->currentGridNetclassId].set(l.m_x, l.m_y, l.m_z, value);
+            return;
+        }
+        GridCellCachedCosts &cell = this->mCachedCosts[this->locationToId(l)];
+        this->touchCachedCosts(cell);
+        cell.cachedViaCost = value;
+    }
+    // Persistent via/trace cost planes of each netclass, kept valid by the board's cost tile versions
+    void setupCostCaches(const int numNetclasses, const bool viaCost, const bool traceCost,
+                         const int tileSize, const int numTilesX, const int numTilesY, const std::vector<unsigned int> *boardCostTileVersion);
+    void clearCostCaches();
+    long long getNumViaCostTileRefreshes() const { return getNumTileRefreshes(mViaCostCaches); }
+    long long getNumTraceCostTileRefreshes() const { return getNumTileRefreshes(mTraceCostCaches); }
+
+    // came from id
+    inline void setCameFromId(const Location &l, const int id) {
+        GridCellSearchState &cell = this->mSearchState[this->locationToId(l)];
+        this->touchSearchState(cell);
+        cell.cameFromId = id;
+    }
+    inline int getCameFromId(const Location &l) const { return this->getCameFromId(this->locationToId(l)); }
+    inline int getCameFromId(const int id) const {
+#ifdef BOUND_CHECKS
+        assert(id < this->size);
+#endif
+        return this->mSearchState[id].searchStamp == this->mSearchEpoch ? this->mSearchState[id].cameFromId : -1;
+    }
+    void clearAllCameFromId();
+
+    // targetPin, flags of the current connection's targets
+    void setTargetedPins(const std::vector<Location> &pins);
+    void clearTargetedPins(const std::vector<Location> &pins);
+    inline void setTargetedPin(const Location &l) { this->mTargetedPin[this->locationToId(l)] = 1; }
+    inline void clearTargetedPin(const Location &l) { this->mTargetedPin[this->locationToId(l)] = 0; }
+    inline bool isTargetedPin(const Location &l) const { return this->mTargetedPin[this->locationToId(l)] != 0; }
+    // Flags the targets and keeps them for the cost estimation
+    void setCurrentTargets(const std::vector<Location> &pinWithLayers);
+    void clearCurrentTargets();
+    // For 2D cost estimation (cares about x and y only)
+    const Location &getCurrentTargetedPin() const { return current_targeted_pin; }
+    // For 3D cost estimation
+    const std::vector<Location> &getCurrentTargetedPinWithLayers() const { return currentTargetedPinWithLayers; }
+    // For 2D multi-target cost estimation, the targets with distinct (x, y) only (z is 0)
+    const std::vector<Location> &getCurrentTargets2D() const { return mCurrentTargets2D; }
+
+    // Log of the searches, std::cout unless a parallel batch buffers it per net
+    std::ostream &log() const { return *mLog; }
+    void setLog(std::ostream *log) { mLog = log ? log : &std::cout; }
+
+    // Search window, the planar neighbors are kept in [minX, maxX] x [minY, maxY]
+    // (clipped to the window limit), resetSearchWindow() opens it up to the limit
+    void setSearchWindow(const int minX, const int minY, const int maxX, const int maxY);
+    void resetSearchWindow();
+    bool isSearchWindowAtLimit() const {
+        return mWindowMinX == mLimitMinX && mWindowMinY == mLimitMinY && mWindowMaxX == mLimitMaxX && mWindowMaxY == mLimitMaxY;
+    }
+    // Hard limit of the search window, the whole grid by default
+    void setSearchWindowLimit(const int minX, const int minY, const int maxX, const int maxY);
+    void resetSearchWindowLimit();
+    bool hasSearchWindowLimit() const {
+        return mLimitMinX > 0 || mLimitMinY > 0 || mLimitMaxX < w - 1 || mLimitMaxY < h - 1;
+    }
+    int getWindowMinX() const { return mWindowMinX; }
+    int getWindowMinY() const { return mWindowMinY; }
+    int getWindowMaxX() const { return mWindowMaxX; }
+    int getWindowMaxY() const { return mWindowMaxY; }
+
+    // Search corridor of GCells (gcellSize x gcellSize cells), the planar neighbors are kept in its GCells
+    void setSearchCorridor(const std::vector<int> &gcellIds, const int gcellSize);
+    void clearSearchCorridor();
+    bool hasSearchCorridor() const { return mCorridorGCellSize > 0; }
+    inline bool isInSearchCorridor(const int x, const int y) const {
+        return mCorridorGCellSize == 0 || mCorridorMask[(y / mCorridorGCellSize) * mNumCorridorGCellsX + x / mCorridorGCellSize];
+    }
+
+    //Constraints
+    void setCurrentGridNetclassId(const int id) { currentGridNetclassId = id; }
+    int getCurrentGridNetclassId() const { return currentGridNetclassId; }
+
+    // Frontiers of aStarSearching(), selected by GlobalParam::gFrontierType
+    BinaryHeapFrontier &getBinaryHeapFrontier() { return mBinaryHeapFrontier; }
+    IndexedQuaternaryHeapFrontier &getIndexedHeapFrontier() { return mIndexedHeapFrontier; }
+    RadixQueueFrontier &getRadixQueueFrontier() { return mRadixQueueFrontier; }
+    // Track the latest frontier entry of each cell
+    template <typename Frontier>
+    void pushToFrontier(const Location &l, const float key, Frontier &frontier) {
+        const int id = this->locationToId(l);
+        GridCellSearchState &state = this->mSearchState[id];
+        this->touchSearchState(state);
+        state.frontierKey = key;
+        frontier.push(l, id, key);
+        ++this->mStatistics.numFrontierPushes;
+    }
+    // Key of the latest frontier entry of a cell, -infinity once expanded, infinity if never pushed
+    inline float frontier_key_at(const Location &l) const {
+        const GridCellSearchState &cell = this->mSearchState[this->locationToId(l)];
+        return cell.searchStamp == this->mSearchEpoch ? cell.frontierKey : std::numeric_limits<float>::infinity();
+    }
+    // Closed-set check of a popped entry, false if it is outdated
+    bool closeFrontierEntry(const Location &l, const float key);
+
+    SearchStatistics &getStatistics() { return mStatistics; }
+    const SearchStatistics &getStatistics() const { return mStatistics; }
+
+    inline int locationToId(const Location &l) const {
+#ifdef BOUND_CHECKS
+        assert(l.m_x + l.m_y * this->w + l.m_z * this->w * this->h < this->size);
+#endif
+        return l.m_x + l.m_y * this->w + l.m_z * this->w * this->h;
+    }
+
+   private:
+    static long long getNumTileRefreshes(const std::vector<CostTileCache> &caches);
+
+    // Bring a cell's stamped state to the current epoch, resetting stale values to defaults
+    inline void touchSearchState(GridCellSearchState &cell) {
+        if (cell.searchStamp != this->mSearchEpoch) {
+            cell.searchStamp = this->mSearchEpoch;
+            cell.workingCost = std::numeric_limits<float>::infinity();
+            cell.bendingCost = 0;
+            cell.cameFromId = -1;
+            cell.frontierKey = std::numeric_limits<float>::infinity();
+            cell.expanded = false;
+        }
+    }
+    inline void touchCachedCosts(GridCellCachedCosts &cell) {
+        if (cell.cacheStamp != this->mCacheEpoch) {
+            cell.cacheStamp = this->mCacheEpoch;
+            cell.cachedTraceCost = -1.0;
+            cell.cachedViaCost = -1.0;
+        }
+    }
+
+   private:
+    int w = 0;
+    int h = 0;
+    int l = 0;
+    int size = 0;  //Total number of cells
+
+    // Per-cell planes, indexed by locationToId()
+    std::vector<GridCellSearchState> mSearchState;
+    std::vector<GridCellCachedCosts> mCachedCosts;
+    std::vector<char> mTargetedPin;
+    // Persistent costs of each netclass, refreshed lazily by tiles
+    mutable std::vector<CostTileCache> mViaCostCaches;
+    mutable std::vector<CostTileCache> mTraceCostCaches;
+    const std::vector<unsigned int> *mBoardCostTileVersion = nullptr;
+
+    // Epochs of the stamped per-cell state, starts from 1 as all stamps are 0 initially
+    unsigned int mSearchEpoch = 1;
+    unsigned int mCacheEpoch = 1;
+
+    std::ostream *mLog = &std::cout;
+
+    int mWindowMinX = 0;
+    int mWindowMinY = 0;
+    int mWindowMaxX = -1;
+    int mWindowMaxY = -1;
+    int mLimitMinX = 0;
+    int mLimitMinY = 0;
+    int mLimitMaxX = -1;
+    int mLimitMaxY = -1;
+
+    int mCorridorGCellSize = 0;  // 0 if no corridor
+    int mNumCorridorGCellsX = 0;
+    std::vector<char> mCorridorMask;
+    std::vector<int> mCorridorGCellIds;
+
+    int currentGridNetclassId = 0;
+    Location current_targeted_pin;
+    //TODO:: Experiment on this...
+    std::vector<Location> currentTargetedPinWithLayers;
+    std::vector<Location> mCurrentTargets2D;
+
+    BinaryHeapFrontier mBinaryHeapFrontier;
+    IndexedQuaternaryHeapFrontier mIndexedHeapFrontier;
+    RadixQueueFrontier mRadixQueueFrontier;
+
+    SearchStatistics mStatistics;
+};
+
+#endif
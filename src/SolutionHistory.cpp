@@ -0,0 +1,57 @@
+#include "SolutionHistory.h"
+
+int SolutionHistory::commit(const std::vector<MultipinRoute> &gridNets) {
+    const std::vector<std::shared_ptr<const MultipinRoute>> *prevVersion = mVersions.empty() ? nullptr : &mVersions.back();
+
+    std::vector<std::shared_ptr<const MultipinRoute>> version;
+    version.reserve(gridNets.size());
+    for (std::size_t i = 0; i < gridNets.size(); ++i) {
+        if (prevVersion && i < prevVersion->size() && prevVersion->at(i)->hasSameRoutingResult(gridNets.at(i))) {
+            version.push_back(prevVersion->at(i));
+            ++mNumSharedRoutes;
+        } else {
+            version.push_back(std::make_shared<const MultipinRoute>(gridNets.at(i)));
+            ++mNumStoredRoutes;
+        }
+    }
+    mVersions.push_back(std::move(version));
+    return static_cast<int>(mVersions.size()) - 1;
+}
+
+void SolutionHistory::restore(const int version, std::vector<MultipinRoute> &gridNets) const {
+    gridNets.clear();
+    gridNets.reserve(mVersions.at(version).size());
+    for (const auto &route : mVersions.at(version)) {
+        gridNets.push_back(*route);
+    }
+}
+
+void SolutionHistory::clear() {
+    mVersions.clear();
+    mNumStoredRoutes = 0;
+    mNumSharedRoutes = 0;
+}
+
+double SolutionHistory::getRoutedWirelength(const int version) const {
+    double overallRoutedWL = 0.0;
+    for (const auto &route : mVersions.at(version)) {
+        overallRoutedWL += route->getRoutedWirelength();
+    }
+    return overallRoutedWL;
+}
+
+int SolutionHistory::getRoutedNumVias(const int version) const {
+    int overallNumVias = 0;
+    for (const auto &route : mVersions.at(version)) {
+        overallNumVias += route->getRoutedNumVias();
+    }
+    return overallNumVias;
+}
+
+int SolutionHistory::getRoutedNumBends(const int version) const {
+    int overallNumBends = 0;
+    for (const auto &route : mVersions.at(version)) {
+        overallNumBends += route->getRoutedNumBends();
+    }
+    return overallNumBends;
+}
@@ -0,0 +1,42 @@
+#ifndef PCBROUTER_SOLUTION_HISTORY_H
+#define PCBROUTER_SOLUTION_HISTORY_H
+
+#include <memory>
+#include <vector>
+
+#include "MultipinRoute.h"
+
+// Routing solutions of the rip-up and re-route iterations. A version holds one
+// shared, immutable copy per net: committing a solution copies only the nets
+// whose routing result differs from the previous version, the others are shared.
+class SolutionHistory {
+   public:
+    //ctor
+    SolutionHistory() {}
+    //dtor
+    ~SolutionHistory() {}
+
+    // Record the nets as a new version, returns its id
+    int commit(const std::vector<MultipinRoute> &gridNets);
+    // Copy the nets of a version out (e.g. to post-process the best solution)
+    void restore(const int version, std::vector<MultipinRoute> &gridNets) const;
+    void clear();
+
+    int getNumVersions() const { return static_cast<int>(mVersions.size()); }
+    const std::vector<std::shared_ptr<const MultipinRoute>> &getVersion(const int version) const { return mVersions.at(version); }
+
+    double getRoutedWirelength(const int version) const;
+    int getRoutedNumVias(const int version) const;
+    int getRoutedNumBends(const int version) const;
+
+    // Nets copied into the history so far, and nets shared with the previous version
+    long long getNumStoredRoutes() const { return mNumStoredRoutes; }
+    long long getNumSharedRoutes() const { return mNumSharedRoutes; }
+
+   private:
+    std::vector<std::vector<std::shared_ptr<const MultipinRoute>>> mVersions;
+    long long mNumStoredRoutes = 0;
+    long long mNumSharedRoutes = 0;
+};
+
+#endif
@@ -0,0 +1,300 @@
+#include "SteinerTree.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
+// Vertices a point is connected to when it is inserted into the tree, and pins paired with a pin for its candidates
+static const int numNearestPoints = 8;
+
+static bool isSamePoint(const Point_2D<int> &p1, const Point_2D<int> &p2) {
+    return p1.x() == p2.x() && p1.y() == p2.y();
+}
+
+double OctilinearSteinerTree::getDistance(const Point_2D<int> &p1, const Point_2D<int> &p2) {
+    int absDiffX = abs(p1.x() - p2.x());
+    int absDiffY = abs(p1.y() - p2.y());
+    int minDiff = std::min(absDiffX, absDiffY);
+    int maxDiff = std::max(absDiffX, absDiffY);
+    return (double)minDiff * GlobalParam::gDiagonalCost + maxDiff - minDiff;
+}
+
+double OctilinearSteinerTree::getMstLength(const std::vector<Point_2D<int>> &points, std::vector<int> *parents) {
+    const int numPoints = static_cast<int>(points.size());
+    std::vector<double> minDistanceToTree(numPoints, std::numeric_limits<double>::max());
+    std::vector<int> parentIds(numPoints, -1);
+    std::vector<bool> isInTree(numPoints, false);
+    double length = 0.0;
+
+    if (numPoints > 0) {
+        minDistanceToTree[0] = 0.0;
+    }
+    for (int k = 0; k < numPoints; ++k) {
+        int nextId = -1;
+        for (int i = 0; i < numPoints; ++i) {
+            if (!isInTree[i] && (nextId == -1 || minDistanceToTree[i] < minDistanceToTree[nextId])) {
+                nextId = i;
+            }
+        }
+        isInTree[nextId] = true;
+        length += minDistanceToTree[nextId];
+        for (int i = 0; i < numPoints; ++i) {
+            if (isInTree[i]) continue;
+            double dis = getDistance(points[nextId], points[i]);
+            if (dis < minDistanceToTree[i]) {
+                minDistanceToTree[i] = dis;
+                parentIds[i] = nextId;
+            }
+        }
+    }
+
+    if (parents) {
+        parents->swap(parentIds);
+    }
+    return length;
+}
+
+double OctilinearSteinerTree::getMstAdjacency(const std::vector<Point_2D<int>> &points, Adjacency &adjacency) {
+    std::vector<int> parents;
+    double length = getMstLength(points, &parents);
+    adjacency.assign(points.size(), std::vector<std::pair<int, double>>());
+    for (std::size_t i = 0; i < parents.size(); ++i) {
+        if (parents[i] >= 0) {
+            double edgeLength = getDistance(points[i], points[parents[i]]);
+            adjacency[i].emplace_back(parents[i], edgeLength);
+            adjacency[parents[i]].emplace_back(static_cast<int>(i), edgeLength);
+        }
+    }
+    return length;
+}
+
+void OctilinearSteinerTree::getNearestPoints(const Point_2D<int> &pt, const std::vector<Point_2D<int>> &points, const int numNearest, std::vector<int> &nearestIds) {
+    std::vector<std::pair<double, int>> distances;
+    distances.reserve(points.size());
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        distances.emplace_back(getDistance(pt, points[i]), static_cast<int>(i));
+    }
+    const int numIds = std::min(numNearest, static_cast<int>(distances.size()));
+    std::partial_sort(distances.begin(), distances.begin() + numIds, distances.end());
+    nearestIds.clear();
+    for (int i = 0; i < numIds; ++i) {
+        nearestIds.push_back(distances[i].second);
+    }
+}
+
+double OctilinearSteinerTree::insertPoint(const Point_2D<int> &pt, const std::vector<Point_2D<int>> &points, Adjacency &adjacency, std::vector<TreeEdge> &removedEdges) {
+    removedEdges.clear();
+    const int newId = static_cast<int>(points.size());
+    std::vector<int> nearestIds;
+    getNearestPoints(pt, points, numNearestPoints, nearestIds);
+    adjacency.emplace_back();
+    if (nearestIds.empty()) {
+        return 0.0;
+    }
+
+    auto removeEdge = [&adjacency](const int u, const int v) {
+        for (const int id : {u, v}) {
+            const int other = id == u ? v : u;
+            auto &edges = adjacency[id];
+            edges.erase(std::find_if(edges.begin(), edges.end(), [other](const std::pair<int, double> &edge) { return edge.first == other; }));
+        }
+    };
+
+    double lengthChange = getDistance(pt, points[nearestIds.front()]);
+    adjacency[newId].emplace_back(nearestIds.front(), lengthChange);
+    adjacency[nearestIds.front()].emplace_back(newId, lengthChange);
+
+    // Path from the new vertex to another nearest vertex, by the parents of a DFS
+    std::vector<int> parents(newId + 1);
+    std::vector<double> parentEdgeLengths(newId + 1, 0.0);
+    std::vector<int> stack;
+    for (std::size_t k = 1; k < nearestIds.size(); ++k) {
+        const int vertexId = nearestIds[k];
+        const double edgeLength = getDistance(pt, points[vertexId]);
+        std::fill(parents.begin(), parents.end(), -2);
+        parents[newId] = -1;
+        stack.assign(1, newId);
+        while (!stack.empty() && parents[vertexId] == -2) {
+            const int u = stack.back();
+            stack.pop_back();
+            for (const auto &edge : adjacency[u]) {
+                if (parents[edge.first] == -2) {
+                    parents[edge.first] = u;
+                    parentEdgeLengths[edge.first] = edge.second;
+                    stack.push_back(edge.first);
+                }
+            }
+        }
+
+        // The longest edge of the cycle closed by the new edge
+        int longestId = vertexId;
+        for (int u = vertexId; parents[u] != -1; u = parents[u]) {
+            if (parentEdgeLengths[u] > parentEdgeLengths[longestId]) {
+                longestId = u;
+            }
+        }
+        if (parentEdgeLengths[longestId] > edgeLength) {
+            removeEdge(longestId, parents[longestId]);
+            removedEdges.push_back(TreeEdge{longestId, parents[longestId], parentEdgeLengths[longestId]});
+            adjacency[newId].emplace_back(vertexId, edgeLength);
+            adjacency[vertexId].emplace_back(newId, edgeLength);
+            lengthChange += edgeLength - parentEdgeLengths[longestId];
+        }
+    }
+    return lengthChange;
+}
+
+void OctilinearSteinerTree::removeInsertedPoint(Adjacency &adjacency, const std::vector<TreeEdge> &removedEdges) {
+    const int newId = static_cast<int>(adjacency.size()) - 1;
+    for (const auto &edge : adjacency[newId]) {
+        auto &edges = adjacency[edge.first];
+        edges.erase(std::find_if(edges.begin(), edges.end(), [newId](const std::pair<int, double> &other) { return other.first == newId; }));
+    }
+    adjacency.pop_back();
+    for (const auto &edge : removedEdges) {
+        adjacency[edge.u].emplace_back(edge.v, edge.length);
+        adjacency[edge.v].emplace_back(edge.u, edge.length);
+    }
+}
+
+void OctilinearSteinerTree::getCandidates(std::vector<Point_2D<int>> &candidates) const {
+    candidates.clear();
+    const std::vector<Point_2D<int>> terminals(mVertices.begin(), mVertices.begin() + mNumTerminals);
+
+    // Crossings of the horizontal, vertical and diagonal (y - x = c1, y + x = c2) lines through
+    // two terminals, the diagonals cross each other on the grid only if c2 - c1 is even
+    auto addCrossings = [&candidates](const Point_2D<int> &p1, const Point_2D<int> &p2) {
+        for (const auto &pts : {std::make_pair(p1, p2), std::make_pair(p2, p1)}) {
+            const Point_2D<int> &a = pts.first;
+            const Point_2D<int> &b = pts.second;
+            const int b1 = b.y() - b.x();
+            const int b2 = b.y() + b.x();
+            candidates.emplace_back(b.x(), a.y());
+            candidates.emplace_back(a.y() - b1, a.y());
+            candidates.emplace_back(b2 - a.y(), a.y());
+            candidates.emplace_back(a.x(), a.x() + b1);
+            candidates.emplace_back(a.x(), b2 - a.x());
+            const int a1 = a.y() - a.x();
+            if ((b2 - a1) % 2 == 0) {
+                candidates.emplace_back((b2 - a1) / 2, (b2 + a1) / 2);
+            }
+        }
+    };
+    int minX = std::numeric_limits<int>::max(), minY = std::numeric_limits<int>::max();
+    int maxX = std::numeric_limits<int>::min(), maxY = std::numeric_limits<int>::min();
+    std::vector<int> nearestIds;
+    for (int i = 0; i < mNumTerminals; ++i) {
+        minX = std::min(minX, terminals[i].x());
+        minY = std::min(minY, terminals[i].y());
+        maxX = std::max(maxX, terminals[i].x());
+        maxY = std::max(maxY, terminals[i].y());
+        // The terminal itself is the nearest one
+        getNearestPoints(terminals[i], terminals, numNearestPoints + 1, nearestIds);
+        for (const int j : nearestIds) {
+            if (j != i) {
+                addCrossings(terminals[i], terminals[j]);
+            }
+        }
+    }
+
+    // Keep the distinct points inside the terminals' bounding box which aren't terminals
+    auto isOutside = [minX, minY, maxX, maxY](const Point_2D<int> &pt) {
+        return pt.x() < minX || pt.x() > maxX || pt.y() < minY || pt.y() > maxY;
+    };
+    candidates.erase(std::remove_if(candidates.begin(), candidates.end(), isOutside), candidates.end());
+    auto isLess = [](const Point_2D<int> &a, const Point_2D<int> &b) {
+        return a.x() < b.x() || (a.x() == b.x() && a.y() < b.y());
+    };
+    std::sort(candidates.begin(), candidates.end(), isLess);
+    candidates.erase(std::unique(candidates.begin(), candidates.end(), isSamePoint), candidates.end());
+    std::vector<Point_2D<int>> sortedTerminals = terminals;
+    std::sort(sortedTerminals.begin(), sortedTerminals.end(), isLess);
+    auto isTerminal = [&sortedTerminals, &isLess](const Point_2D<int> &pt) {
+        return std::binary_search(sortedTerminals.begin(), sortedTerminals.end(), pt, isLess);
+    };
+    candidates.erase(std::remove_if(candidates.begin(), candidates.end(), isTerminal), candidates.end());
+}
+
+void OctilinearSteinerTree::removeRedundantSteinerPoints() {
+    bool removed = true;
+    while (removed) {
+        removed = false;
+        std::vector<int> parents;
+        getMstLength(mVertices, &parents);
+        std::vector<int> degrees(mVertices.size(), 0);
+        for (std::size_t i = 0; i < parents.size(); ++i) {
+            if (parents[i] >= 0) {
+                ++degrees[i];
+                ++degrees[parents[i]];
+            }
+        }
+        for (int i = static_cast<int>(mVertices.size()) - 1; i >= mNumTerminals; --i) {
+            if (degrees[i] <= 2) {
+                mVertices.erase(mVertices.begin() + i);
+                removed = true;
+            }
+        }
+    }
+    mLength = getMstLength(mVertices, nullptr);
+}
+
+void OctilinearSteinerTree::build(const std::vector<Point_2D<int>> &terminals) {
+    const double eps = 1e-6;
+    mVertices = terminals;
+    mNumTerminals = static_cast<int>(terminals.size());
+    mEdges.clear();
+    mMstLength = getMstLength(mVertices, nullptr);
+    mLength = mMstLength;
+
+    if (mNumTerminals >= 3) {
+        std::vector<Point_2D<int>> candidates;
+        this->getCandidates(candidates);
+
+        // A tree of n terminals has at most n - 2 useful Steiner points
+        Adjacency adjacency;
+        std::vector<TreeEdge> removedEdges;
+        for (int round = 0; round < mNumTerminals; ++round) {
+            // Gains of the candidates against the current tree
+            mLength = getMstAdjacency(mVertices, adjacency);
+            std::vector<std::pair<double, int>> gains;
+            for (std::size_t i = 0; i < candidates.size(); ++i) {
+                const Point_2D<int> &candidate = candidates[i];
+                if (std::find_if(mVertices.begin(), mVertices.end(), [&candidate](const Point_2D<int> &pt) { return isSamePoint(pt, candidate); }) != mVertices.end()) continue;
+                double lengthChange = insertPoint(candidate, mVertices, adjacency, removedEdges);
+                removeInsertedPoint(adjacency, removedEdges);
+                if (lengthChange < -eps) {
+                    gains.emplace_back(-lengthChange, static_cast<int>(i));
+                }
+            }
+            if (gains.empty()) {
+                break;
+            }
+            std::stable_sort(gains.begin(), gains.end(), [](const std::pair<double, int> &a, const std::pair<double, int> &b) { return a.first > b.first; });
+
+            // Add them in the order of the gains, as long as each one still shortens the tree
+            bool improved = false;
+            for (const auto &gain : gains) {
+                double lengthChange = insertPoint(candidates[gain.second], mVertices, adjacency, removedEdges);
+                if (lengthChange < -eps) {
+                    mVertices.push_back(candidates[gain.second]);
+                    mLength += lengthChange;
+                    improved = true;
+                } else {
+                    removeInsertedPoint(adjacency, removedEdges);
+                }
+            }
+            this->removeRedundantSteinerPoints();
+            if (!improved) {
+                break;
+            }
+        }
+    }
+
+    std::vector<int> parents;
+    mLength = getMstLength(mVertices, &parents);
+    for (std::size_t i = 0; i < parents.size(); ++i) {
+        if (parents[i] >= 0) {
+            mEdges.emplace_back(parents[i], static_cast<int>(i));
+        }
+    }
+}
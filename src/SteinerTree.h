@@ -0,0 +1,68 @@
+#ifndef PCBROUTER_STEINER_TREE_H
+#define PCBROUTER_STEINER_TREE_H
+
+#include <utility>
+#include <vector>
+
+#include "globalParam.h"
+#include "point.h"
+
+// Octilinear Steiner tree of a net's pin centers, by batched iterated 1-Steiner:
+// candidate points (crossings of the horizontal, vertical and diagonal lines through
+// each pin and its nearest pins) are added while they shorten the spanning tree, and
+// Steiner points of degree <= 2 are dropped. A candidate's gain is found by inserting
+// it into the tree, connected to its nearest vertices, in O(n) instead of a new O(n^2)
+// minimum spanning tree, so high-degree nets stay fast.
+class OctilinearSteinerTree {
+   public:
+    //ctor
+    OctilinearSteinerTree() {}
+    //dtor
+    ~OctilinearSteinerTree() {}
+
+    void build(const std::vector<Point_2D<int>> &terminals);
+
+    // Terminals first (in the given order), then the Steiner points
+    const std::vector<Point_2D<int>> &getVertices() const { return mVertices; }
+    int getNumTerminals() const { return mNumTerminals; }
+    int getNumSteinerPoints() const { return static_cast<int>(mVertices.size()) - mNumTerminals; }
+    bool isSteinerPoint(const int vertexId) const { return vertexId >= mNumTerminals; }
+    const std::vector<std::pair<int, int>> &getEdges() const { return mEdges; }
+    double getLength() const { return mLength; }
+    // Minimum spanning tree length of the terminals only
+    double getMstLength() const { return mMstLength; }
+
+    // Octilinear distance, the same as the pins' distance of the routing order
+    static double getDistance(const Point_2D<int> &p1, const Point_2D<int> &p2);
+
+   private:
+    // Edges of a spanning tree by vertex, (adjacent vertex, length)
+    using Adjacency = std::vector<std::vector<std::pair<int, double>>>;
+    struct TreeEdge {
+        int u;
+        int v;
+        double length;
+    };
+
+    // Prim's minimum spanning tree in O(n^2), parents[i] is -1 for the root
+    static double getMstLength(const std::vector<Point_2D<int>> &points, std::vector<int> *parents);
+    static double getMstAdjacency(const std::vector<Point_2D<int>> &points, Adjacency &adjacency);
+    // Ids of the (at most) numNearest points closest to pt, the closest first
+    static void getNearestPoints(const Point_2D<int> &pt, const std::vector<Point_2D<int>> &points, const int numNearest, std::vector<int> &nearestIds);
+    // Add pt to the tree as the vertex points.size(), connected to its nearest vertices: each edge to a vertex
+    // replaces the longest edge of the cycle it closes if it is shorter. Returns the change of the tree length,
+    // the replaced edges are kept for removeInsertedPoint()
+    static double insertPoint(const Point_2D<int> &pt, const std::vector<Point_2D<int>> &points, Adjacency &adjacency, std::vector<TreeEdge> &removedEdges);
+    static void removeInsertedPoint(Adjacency &adjacency, const std::vector<TreeEdge> &removedEdges);
+    void getCandidates(std::vector<Point_2D<int>> &candidates) const;
+    // Drop the Steiner points of degree <= 2, they can't shorten the tree
+    void removeRedundantSteinerPoints();
+
+    std::vector<Point_2D<int>> mVertices;
+    int mNumTerminals = 0;
+    std::vector<std::pair<int, int>> mEdges;
+    double mLength = 0.0;
+    double mMstLength = 0.0;
+};
+
+#endif
@@ -29,6 +29,44 @@ bool GlobalParam::gUseMircoVia = true;
 bool GlobalParam::gAllowViaForRouting = true;
 bool GlobalParam::gCurvingObstacleCost = true;
 unsigned int GlobalParam::gNumRipUpReRouteIteration = 5;
+bool GlobalParam::gSearchEpochReset = true;  //Reset search state by epoch stamps instead of full-grid fills
+bool GlobalParam::gRowPrefixSumCost = false;  //Query sized trace/via costs by row prefix sums of the base cost
+FrontierType GlobalParam::gFrontierType = FrontierType::BINARY_HEAP;
+double GlobalParam::gRadixQueueKeyScale = 100.0;  //Keys are quantized to 1/100 in the radix queue
+unsigned int GlobalParam::gNumRoutingThreads = 0;  //0: route the signal nets one by one, otherwise in batches of disjoint nets
+unsigned int GlobalParam::gParallelRoutingMargin = 10;  //Search margin (in grids) around a net's pins when batching
+bool GlobalParam::gNegotiatedCongestion = false;  //PathFinder-style rip-up and reroute of the nets sharing grids
+double GlobalParam::gPresentCongestionCost = 10.0;  //Initial cost per other net occupying a grid
+double GlobalParam::gPresentCongestionGrowth = 1.5;  //Present congestion cost factor per iteration
+double GlobalParam::gHistoryCongestionCost = 5.0;  //History cost added per overflow of a grid in each iteration
+bool GlobalParam::gSelectiveRipUp = false;  //Rip-up and reroute only the nets in conflicts (and their neighbors)
+unsigned int GlobalParam::gConflictNeighborMargin = 5;  //Nets within this distance (in grids) of a conflict are rerouted as well
+bool GlobalParam::gBoundedSearchWindow = false;  //Confine A* to the bounding box of the source tree and the targets
+unsigned int GlobalParam::gSearchWindowMargin = 20;  //Margin (in grids) of the search window
+double GlobalParam::gSearchWindowGrowth = 2.0;  //Margin factor when retrying a failed search in a larger window
+bool GlobalParam::gPersistentViaCost = false;  //Keep the via costs of each netclass across routes, refreshed by tiles
+bool GlobalParam::gPersistentTraceCost = false;  //Keep the trace costs of each netclass across routes, refreshed by tiles
+int GlobalParam::gCostCacheTileSize = 16;  //Tile size (in grids) of the persistent cost caches
+bool GlobalParam::gBaseCostJournal = false;  //Record the base cost added by each net, rip-up replays it instead of re-rasterizing
+bool GlobalParam::gBacktrackToSegments = false;  //Backtracking emits the corner points of a path only, instead of every cell
+bool GlobalParam::gMultiTerminalSearch = false;  //Route a net's pins by growing one search tree instead of an A* per pin
+bool GlobalParam::gIncrementalSearch = false;  //Resume the search of the previous pin connection of a net instead of restarting it
+bool GlobalParam::gSteinerTreePinOrdering = false;  //Order a net's pins along the octilinear Steiner tree of the pins
+unsigned int GlobalParam::gSteinerTreeMaxPins = 512;  //Nets with more pins are ordered by the minimum spanning tree only (a 512-pin tree takes ~1.5 s)
+bool GlobalParam::gSteinerPointTargets = false;  //Route to the Steiner points as intermediate targets, before the pins branching from them
+bool GlobalParam::gGlobalRouting = false;  //Route the nets on coarse GCells first, and keep the detailed searches in their corridors
+unsigned int GlobalParam::gGCellSize = 16;  //GCell width/height in grid cells
+unsigned int GlobalParam::gCorridorMargin = 2;  //GCells around a net's global route that are also in its corridor
+double GlobalParam::gGCellOverflowCost = 10.0;  //Global routing cost per net over the capacity of a GCell
+bool GlobalParam::gHierarchicalSearch = false;  //Solve each connection on a coarse level of the cost pyramid first, and refine it in a band around the coarse path
+unsigned int GlobalParam::gHierarchicalSearchLevel = 3;  //Pyramid level of the coarse search, its cells are 2^level x 2^level grid cells
+unsigned int GlobalParam::gHierarchicalBandMargin = 1;  //Coarse cells around the coarse path that are also in the refinement band
+double GlobalParam::gConvergenceThreshold = 0.001;  //Relative improvement of the best cost below which an RRR iteration is stalled
+unsigned int GlobalParam::gConvergencePatience = 0;  //Stop RRR after this many stalled iterations in a row, 0 to disable
+bool GlobalParam::gStopOnZeroOverflow = false;  //Track the grid occupancy and stop RRR once no two nets overlap
+double GlobalParam::gRipUpReRouteTimeLimit = 0.0;  //Wall-clock budget (in seconds) of the RRR iterations, 0 for unlimited
+bool GlobalParam::gSpeculativeRipUpReRoute = false;  //Roll back an RRR iteration of route_all() that makes the total cost worse
+bool GlobalParam::gReportParallelScaling = false;  //Time the first batched iteration with 1 to 32 threads (rolled back) before routing it
 // Outputfile
 int GlobalParam::gOutputPrecision = 5;
 string GlobalParam::gOutputFolder = "output";
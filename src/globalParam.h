@@ -34,6 +34,12 @@ enum VerboseLevel {
     DEFAULT = WARN
 };
 
+enum FrontierType {
+    BINARY_HEAP = 0,              // LocationQueue, duplicated entries on improvements
+    INDEXED_QUATERNARY_HEAP = 1,  // Indexed 4-ary heap with decrease-key
+    RADIX_QUEUE = 2               // Radix heap on quantized keys
+};
+
 class GlobalParam {
    public:
     static int gLayerNum;
@@ -71,6 +77,44 @@ class GlobalParam {
     static bool gAllowViaForRouting;
     static bool gCurvingObstacleCost;
     static unsigned int gNumRipUpReRouteIteration;
+    static bool gSearchEpochReset;
+    static bool gRowPrefixSumCost;
+    static FrontierType gFrontierType;
+    static double gRadixQueueKeyScale;
+    static unsigned int gNumRoutingThreads;
+    static unsigned int gParallelRoutingMargin;
+    static bool gNegotiatedCongestion;
+    static double gPresentCongestionCost;
+    static double gPresentCongestionGrowth;
+    static double gHistoryCongestionCost;
+    static bool gSelectiveRipUp;
+    static unsigned int gConflictNeighborMargin;
+    static bool gBoundedSearchWindow;
+    static unsigned int gSearchWindowMargin;
+    static double gSearchWindowGrowth;
+    static bool gPersistentViaCost;
+    static bool gPersistentTraceCost;
+    static int gCostCacheTileSize;
+    static bool gBaseCostJournal;
+    static bool gBacktrackToSegments;
+    static bool gMultiTerminalSearch;
+    static bool gIncrementalSearch;
+    static bool gSteinerTreePinOrdering;
+    static unsigned int gSteinerTreeMaxPins;
+    static bool gSteinerPointTargets;
+    static bool gGlobalRouting;
+    static unsigned int gGCellSize;
+    static unsigned int gCorridorMargin;
+    static double gGCellOverflowCost;
+    static bool gHierarchicalSearch;
+    static unsigned int gHierarchicalSearchLevel;
+    static unsigned int gHierarchicalBandMargin;
+    static double gConvergenceThreshold;
+    static unsigned int gConvergencePatience;
+    static bool gStopOnZeroOverflow;
+    static double gRipUpReRouteTimeLimit;
+    static bool gSpeculativeRipUpReRoute;
+    static bool gReportParallelScaling;
 
     //Outputfile
     static int gOutputPrecision;